@@ -35,6 +35,13 @@ LevelMeterAudioProcessor::LevelMeterAudioProcessor()
     parameters.addParameterListener("right", this);
     parameters.addParameterListener("rmsPeriod", this);
     parameters.addParameterListener("smoothing", this);
+
+    //picks (and logs) the kernel variant for this CPU before the first block
+    Utility::getSimdKernels();
+
+   #if LEVELMETER_RUN_BENCHMARKS
+    Logger::writeToLog(Utility::benchmarkSimdKernels());
+   #endif
 }
 
 LevelMeterAudioProcessor::~LevelMeterAudioProcessor()
@@ -210,13 +217,13 @@ void LevelMeterAudioProcessor::processBlock(juce::AudioBuffer<float>& buffer, ju
         const auto startGain = gainLeft.getCurrentValue();
         gainLeft.skip(numSamples);
         const auto endGain = gainLeft.getCurrentValue();
-        buffer.applyGainRamp(0, 0, numSamples, startGain, endGain);
+        Utility::applyGainRamp(buffer.getWritePointer(0), numSamples, startGain, endGain);
     }
     {
         const auto startGain = gainRight.getCurrentValue();
         gainRight.skip(numSamples);
         const auto endGain = gainRight.getCurrentValue();
-        buffer.applyGainRamp(1, 0, numSamples, startGain, endGain);
+        Utility::applyGainRamp(buffer.getWritePointer(1), numSamples, startGain, endGain);
     }
 
     for (auto& rmsLevel : rmsLevels)
@@ -269,7 +276,7 @@ std::vector<float> LevelMeterAudioProcessor::getRmsLevels()
     for (auto channel = 0; channel < rmsCalculationBuffer.getNumChannels(); channel++)
     {
         processLevelValue(rmsLevels[channel],
-                          Decibels::gainToDecibels(rmsCalculationBuffer.getRMSLevel(channel, 0, rmsWindowSize)));
+                          Decibels::gainToDecibels(Utility::getRmsLevel(rmsCalculationBuffer.getReadPointer(channel), rmsWindowSize)));
         levels.push_back(rmsLevels[channel].getCurrentValue());
     }
     return levels;
@@ -285,7 +292,7 @@ float LevelMeterAudioProcessor::getRmsLevel(const int channel)
     jassert(channel >= 0 && channel < rmsCalculationBuffer.getNumChannels());
     rmsFifo.pull(rmsCalculationBuffer.getWritePointer(channel), channel, rmsWindowSize);
     processLevelValue(rmsLevels[channel],
-                      Decibels::gainToDecibels(rmsCalculationBuffer.getRMSLevel(channel, 0, rmsWindowSize)));
+                      Decibels::gainToDecibels(Utility::getRmsLevel(rmsCalculationBuffer.getReadPointer(channel), rmsWindowSize)));
     return rmsLevels[channel].getCurrentValue();
 }
 
@@ -2,6 +2,7 @@
 
 #include <JuceHeader.h>
 #include "Utility/Fifo.h"
+#include "Utility/SimdKernels.h"
 
 class LevelMeterAudioProcessor  : public juce::AudioProcessor,
     public AudioProcessorValueTreeState::Listener
@@ -0,0 +1,237 @@
+/*
+  ==============================================================================
+
+    SimdKernels.h
+    Created: 19 Oct 2026 5:12:37pm
+    Author:  tyzTang
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+#if JUCE_INTEL
+ #include <immintrin.h>
+ #if JUCE_MSVC
+  #define LEVELMETER_TARGET(isa)
+ #else
+  #define LEVELMETER_TARGET(isa) __attribute__((target(isa)))
+ #endif
+#endif
+
+namespace Utility
+{
+    /*
+     RMS and gain reductions of the meter, compiled per ISA and picked at runtime
+     so the plugin itself can stay on the baseline instruction set.
+     */
+    struct SimdKernels
+    {
+        const char* name;
+        float (*sumOfSquares)(const float* data, int num);
+        void (*applyGainRamp)(float* data, int num, float startGain, float endGain);
+    };
+
+    namespace Kernels
+    {
+        inline float sumOfSquaresScalar(const float* data, int num)
+        {
+            double sum = 0.0;
+            for (int i = 0; i < num; ++i)
+                sum += data[i] * data[i];
+            return static_cast<float>(sum);
+        }
+
+        inline void applyGainRampScalar(float* data, int num, float startGain, float endGain)
+        {
+            const auto increment = (endGain - startGain) / static_cast<float>(num);
+            for (int i = 0; i < num; ++i)
+                data[i] *= startGain + increment * static_cast<float>(i);
+        }
+
+       #if JUCE_INTEL
+        LEVELMETER_TARGET("sse2") inline float sumOfSquaresSSE2(const float* data, int num)
+        {
+            auto sum = _mm_setzero_ps();
+            int i = 0;
+            for (; i + 4 <= num; i += 4)
+            {
+                const auto v = _mm_loadu_ps(data + i);
+                sum = _mm_add_ps(sum, _mm_mul_ps(v, v));
+            }
+
+            alignas(16) float lanes[4];
+            _mm_store_ps(lanes, sum);
+            return lanes[0] + lanes[1] + lanes[2] + lanes[3] + sumOfSquaresScalar(data + i, num - i);
+        }
+
+        LEVELMETER_TARGET("sse2") inline void applyGainRampSSE2(float* data, int num, float startGain, float endGain)
+        {
+            const auto increment = (endGain - startGain) / static_cast<float>(num);
+            const auto step = _mm_set1_ps(4.f * increment);
+            auto gain = _mm_add_ps(_mm_set1_ps(startGain), _mm_mul_ps(_mm_setr_ps(0.f, 1.f, 2.f, 3.f), _mm_set1_ps(increment)));
+
+            int i = 0;
+            for (; i + 4 <= num; i += 4)
+            {
+                _mm_storeu_ps(data + i, _mm_mul_ps(_mm_loadu_ps(data + i), gain));
+                gain = _mm_add_ps(gain, step);
+            }
+
+            for (; i < num; ++i)
+                data[i] *= startGain + increment * static_cast<float>(i);
+        }
+
+        LEVELMETER_TARGET("avx2,fma") inline float sumOfSquaresAVX2(const float* data, int num)
+        {
+            auto sum = _mm256_setzero_ps();
+            int i = 0;
+            for (; i + 8 <= num; i += 8)
+            {
+                const auto v = _mm256_loadu_ps(data + i);
+                sum = _mm256_fmadd_ps(v, v, sum);
+            }
+
+            const auto half = _mm_add_ps(_mm256_castps256_ps128(sum), _mm256_extractf128_ps(sum, 1));
+            alignas(16) float lanes[4];
+            _mm_store_ps(lanes, half);
+            return lanes[0] + lanes[1] + lanes[2] + lanes[3] + sumOfSquaresScalar(data + i, num - i);
+        }
+
+        LEVELMETER_TARGET("avx2,fma") inline void applyGainRampAVX2(float* data, int num, float startGain, float endGain)
+        {
+            const auto increment = (endGain - startGain) / static_cast<float>(num);
+            const auto step = _mm256_set1_ps(8.f * increment);
+            auto gain = _mm256_fmadd_ps(_mm256_setr_ps(0.f, 1.f, 2.f, 3.f, 4.f, 5.f, 6.f, 7.f),
+                                        _mm256_set1_ps(increment), _mm256_set1_ps(startGain));
+
+            int i = 0;
+            for (; i + 8 <= num; i += 8)
+            {
+                _mm256_storeu_ps(data + i, _mm256_mul_ps(_mm256_loadu_ps(data + i), gain));
+                gain = _mm256_add_ps(gain, step);
+            }
+
+            for (; i < num; ++i)
+                data[i] *= startGain + increment * static_cast<float>(i);
+        }
+
+        LEVELMETER_TARGET("avx512f") inline float sumOfSquaresAVX512(const float* data, int num)
+        {
+            auto sum = _mm512_setzero_ps();
+            int i = 0;
+            for (; i + 16 <= num; i += 16)
+            {
+                const auto v = _mm512_loadu_ps(data + i);
+                sum = _mm512_fmadd_ps(v, v, sum);
+            }
+
+            return _mm512_reduce_add_ps(sum) + sumOfSquaresScalar(data + i, num - i);
+        }
+
+        LEVELMETER_TARGET("avx512f") inline void applyGainRampAVX512(float* data, int num, float startGain, float endGain)
+        {
+            const auto increment = (endGain - startGain) / static_cast<float>(num);
+            const auto step = _mm512_set1_ps(16.f * increment);
+            auto gain = _mm512_fmadd_ps(_mm512_setr_ps(0.f, 1.f, 2.f, 3.f, 4.f, 5.f, 6.f, 7.f,
+                                                       8.f, 9.f, 10.f, 11.f, 12.f, 13.f, 14.f, 15.f),
+                                        _mm512_set1_ps(increment), _mm512_set1_ps(startGain));
+
+            int i = 0;
+            for (; i + 16 <= num; i += 16)
+            {
+                _mm512_storeu_ps(data + i, _mm512_mul_ps(_mm512_loadu_ps(data + i), gain));
+                gain = _mm512_add_ps(gain, step);
+            }
+
+            for (; i < num; ++i)
+                data[i] *= startGain + increment * static_cast<float>(i);
+        }
+       #endif
+    }
+
+    //every variant this CPU can run, slowest first
+    inline std::vector<const SimdKernels*> getSupportedSimdKernels()
+    {
+        static const SimdKernels scalar{"Scalar", Kernels::sumOfSquaresScalar, Kernels::applyGainRampScalar};
+        std::vector<const SimdKernels*> supported{&scalar};
+
+       #if JUCE_INTEL
+        static const SimdKernels sse2{"SSE2", Kernels::sumOfSquaresSSE2, Kernels::applyGainRampSSE2};
+        static const SimdKernels avx2{"AVX2", Kernels::sumOfSquaresAVX2, Kernels::applyGainRampAVX2};
+        static const SimdKernels avx512{"AVX-512", Kernels::sumOfSquaresAVX512, Kernels::applyGainRampAVX512};
+
+        const auto hasAVX2 = SystemStats::hasAVX2() && SystemStats::hasFMA3();
+
+        if (SystemStats::hasSSE2())
+            supported.push_back(&sse2);
+        if (hasAVX2)
+            supported.push_back(&avx2);
+        if (hasAVX2 && SystemStats::hasAVX512F())
+            supported.push_back(&avx512);
+       #endif
+
+        return supported;
+    }
+
+    //best variant the CPU supports, chosen (and reported to the log) on first use
+    inline const SimdKernels& getSimdKernels()
+    {
+        static const SimdKernels& selected = []() -> const SimdKernels&
+        {
+            const auto* best = getSupportedSimdKernels().back();
+
+            Logger::writeToLog("LevelMeter: SIMD kernels dispatched to " + String(best->name)
+                               + " (" + SystemStats::getCpuModel() + ")");
+            return *best;
+        }();
+
+        return selected;
+    }
+
+    //throughput of every supported variant in Msamples/s, one line each
+    inline String benchmarkSimdKernels(int numSamples = 1 << 16, int numRuns = 200)
+    {
+        std::vector<float> data(static_cast<size_t>(numSamples));
+        Random random;
+        for (auto& sample : data)
+            sample = random.nextFloat() * 2.f - 1.f;
+
+        String report;
+        for (const auto* kernels : getSupportedSimdKernels())
+        {
+            volatile float sink = 0.f;
+            auto start = Time::getHighResolutionTicks();
+            for (int run = 0; run < numRuns; ++run)
+                sink = sink + kernels->sumOfSquares(data.data(), numSamples);
+            const auto rmsSeconds = Time::highResolutionTicksToSeconds(Time::getHighResolutionTicks() - start);
+
+            start = Time::getHighResolutionTicks();
+            for (int run = 0; run < numRuns; ++run)
+                kernels->applyGainRamp(data.data(), numSamples, 1.f, 1.f + 1.0e-6f);
+            const auto gainSeconds = Time::highResolutionTicksToSeconds(Time::getHighResolutionTicks() - start);
+
+            const auto samples = static_cast<double>(numSamples) * numRuns * 1.0e-6;
+            report << kernels->name << ": rms " << String(samples / rmsSeconds, 1)
+                << " Msamples/s, gain ramp " << String(samples / gainSeconds, 1) << " Msamples/s" << newLine;
+        }
+
+        return report;
+    }
+
+    inline float getRmsLevel(const float* data, int num)
+    {
+        if (num <= 0)
+            return 0.f;
+
+        return std::sqrt(getSimdKernels().sumOfSquares(data, num) / static_cast<float>(num));
+    }
+
+    inline void applyGainRamp(float* data, int num, float startGain, float endGain)
+    {
+        if (num > 0)
+            getSimdKernels().applyGainRamp(data, num, startGain, endGain);
+    }
+}
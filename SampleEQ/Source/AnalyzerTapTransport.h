@@ -0,0 +1,398 @@
+/*
+  ==============================================================================
+
+    AnalyzerTapTransport.h
+    Created: 19 Oct 2026 8:52:19pm
+    Author:  tyzTang
+
+  ==============================================================================
+*/
+
+#pragma once
+#include <JuceHeader.h>
+
+#include "AnalyzerWorker.h"
+
+enum AnalyzerTap
+{
+    AnalyzerTap_Pre, //input of the EQ
+    AnalyzerTap_Post, //output of the EQ
+    AnalyzerTap_Difference, //post - pre, what the EQ added or took away; pre delayed by the EQ's latency
+};
+
+/*
+ Audio thread -> analyzer transport for all tap points at once.
+
+ One lock-free sample ring with two channels per tap. The audio thread
+ reserves a block's worth of space once, writes the pre tap straight into it
+ before the EQ runs and the post / difference taps after, then commits the
+ block; every tap is published once per block without intermediate copies.
+ Taps nobody listens to are not written, with no listeners at all the
+ audio thread does nothing beyond reading the counts.
+
+ The ring only has to bridge the gap between two analyzer passes, the FFT
+ window itself lives with the reader. It is sized from the block size and
+ sample rate, allocated when the first listener arrives and freed when the
+ last one leaves, so a processor without an open editor holds no ring at all.
+
+ Single reader: the analyzer thread pulls the newest samples of one tap,
+ inside a ScopedRead. The audio thread and the reader each pin the storage
+ for a block or a pass; releasing it never waits for them beyond a short
+ bound, storage still pinned is retired and freed on a later call.
+ */
+class AnalyzerTapTransport
+{
+public:
+    static constexpr int numTaps = 3;
+
+    //the analyzer may run this many passes late before a block is dropped
+    static constexpr int readerSlackMilliseconds = 8 * AnalyzerWorker::intervalMilliseconds;
+
+    ~AnalyzerTapTransport()
+    {
+        //the audio thread and every reader are gone by now
+        const juce::ScopedLock sl(allocationLock);
+        release();
+        retired.clear();
+    }
+
+    //prepareToPlay, before the audio is touched; 'maxLatency' is the most the EQ can delay its output by
+    void prepare(double sampleRate, int samplesPerBlock, int maxLatency)
+    {
+        const juce::ScopedLock sl(allocationLock);
+
+        //two blocks in flight plus the reader's slack
+        const auto slack = (int)std::ceil(sampleRate * readerSlackMilliseconds / 1000.0);
+        capacity = juce::nextPowerOfTwo(2 * samplesPerBlock + slack);
+        maxDifferenceLatency = juce::jmax(0, maxLatency);
+
+        if (hasListeners())
+            allocate();
+        else
+            release();
+    }
+
+    //message thread, a listener keeps its tap published until it is removed
+    void addListener(AnalyzerTap tap)
+    {
+        const juce::ScopedLock sl(allocationLock);
+        freeRetired(0);
+
+        if (!hasListeners())
+            allocate();
+
+        ++listeners[tap];
+    }
+
+    void removeListener(AnalyzerTap tap)
+    {
+        const juce::ScopedLock sl(allocationLock);
+        freeRetired(0);
+
+        if (--listeners[tap] == 0 && !hasListeners())
+            release();
+    }
+
+    /*
+     The EQ's current latency, any thread. The difference tap subtracts the
+     pre samples from that long ago, so both sides are the same moment.
+     */
+    void setDifferenceLatency(int latencyInSamples)
+    {
+        differenceLatency.store(juce::jlimit(0, maxDifferenceLatency.load(), latencyInSamples));
+    }
+
+    bool hasListeners() const
+    {
+        return listeners[AnalyzerTap_Pre].load() + listeners[AnalyzerTap_Post].load()
+               + listeners[AnalyzerTap_Difference].load() > 0;
+    }
+
+    //audio thread, 'buffer' before processing
+    void capturePre(const juce::AudioBuffer<float>& buffer)
+    {
+        blockTaps = 0;
+
+        //the storage can't be freed from under the block while this is set
+        audioThreadBusy.store(true);
+        block = storage.load();
+        if (block == nullptr || buffer.getNumChannels() == 0)
+        {
+            endBlock();
+            return;
+        }
+
+        for (int tap = 0; tap < numTaps; ++tap)
+            if (listeners[tap].load(std::memory_order_relaxed) > 0)
+                blockTaps |= 1 << tap;
+
+        //the difference needs the input too
+        if (blockTaps & (1 << AnalyzerTap_Difference))
+            blockTaps |= 1 << AnalyzerTap_Pre;
+
+        //reader fell behind: this block is dropped, the ring keeps the older audio
+        if (blockTaps == 0 || block->fifo.getFreeSpace() < buffer.getNumSamples())
+        {
+            block->preDelayValid = false;
+            endBlock();
+            return;
+        }
+
+        if (blockTaps & (1 << AnalyzerTap_Pre))
+            write(AnalyzerTap_Pre, buffer);
+    }
+
+    //audio thread, the same 'buffer' after processing, commits the block
+    void publishPost(const juce::AudioBuffer<float>& buffer)
+    {
+        if (blockTaps == 0)
+            return;
+
+        if (blockTaps & (1 << AnalyzerTap_Post))
+            write(AnalyzerTap_Post, buffer);
+
+        if (blockTaps & (1 << AnalyzerTap_Difference))
+            writeDifference(buffer);
+        else
+            block->preDelayValid = false;
+
+        block->fifo.finishedWrite(buffer.getNumSamples());
+        endBlock();
+    }
+
+    //reader, held over a whole pass; the storage it pinned stays allocated until it ends
+    struct ScopedRead
+    {
+        explicit ScopedRead(AnalyzerTapTransport& t) : transport(t)
+        {
+            transport.readerBusy.store(true);
+            transport.readerStorage = transport.storage.load();
+        }
+
+        ~ScopedRead()
+        {
+            transport.readerStorage = nullptr;
+            transport.readerBusy.store(false);
+        }
+
+        AnalyzerTapTransport& transport;
+    };
+
+    //reader, inside a ScopedRead
+    int getNumReady() const { return readerStorage != nullptr ? readerStorage->fifo.getNumReady() : 0; }
+
+    /*
+     Drops 'numToSkip' samples, then copies the next 'numToCopy' samples of
+     'tap' into both channels of 'destination' at 'destStartSample'.
+     */
+    void read(AnalyzerTap tap, juce::AudioBuffer<float>& destination, int destStartSample, int numToSkip, int numToCopy)
+    {
+        jassert(readerStorage != nullptr);
+        auto& fifo = readerStorage->fifo;
+        fifo.finishedRead(numToSkip);
+
+        int start1, size1, start2, size2;
+        fifo.prepareToRead(numToCopy, start1, size1, start2, size2);
+
+        for (int channel = 0; channel < 2; ++channel)
+        {
+            const auto* source = readerStorage->ring.getReadPointer(tap * 2 + channel);
+            auto* dest = destination.getWritePointer(channel, destStartSample);
+
+            if (size1 > 0)
+                juce::FloatVectorOperations::copy(dest, source + start1, size1);
+            if (size2 > 0)
+                juce::FloatVectorOperations::copy(dest + size1, source + start2, size2);
+        }
+
+        fifo.finishedRead(size1 + size2);
+    }
+
+    //bytes held by the ring and any retired storage, 0 while nobody listens
+    size_t getMemoryUsage() const
+    {
+        const juce::ScopedLock sl(allocationLock);
+
+        size_t bytes = active != nullptr ? active->getMemoryUsage() : 0;
+        for (const auto& old : retired)
+            bytes += old->getMemoryUsage();
+
+        return bytes;
+    }
+
+private:
+    struct Storage
+    {
+        juce::AudioBuffer<float> ring;
+        juce::AbstractFifo fifo;
+
+        //pre samples waiting to be subtracted, audio thread only
+        juce::AudioBuffer<float> preDelay;
+        int preDelayLength = 0, preDelayPosition = 0;
+        bool preDelayValid = false; //false after a block without the difference tap, the history has a gap
+
+        //the fifo keeps one slot free, its indices run up to 'capacity'
+        Storage(int capacity, int maxLatency) : fifo(capacity + 1)
+        {
+            ring.setSize(numTaps * 2, capacity + 1);
+            ring.clear();
+            preDelay.setSize(2, juce::jmax(1, maxLatency));
+            preDelay.clear();
+        }
+
+        size_t getMemoryUsage() const
+        {
+            return ((size_t)ring.getNumChannels() * (size_t)ring.getNumSamples()
+                    + (size_t)preDelay.getNumChannels() * (size_t)preDelay.getNumSamples()) * sizeof(float);
+        }
+    };
+
+    //audio thread, the block no longer touches the storage
+    void endBlock()
+    {
+        blockTaps = 0;
+        block = nullptr;
+        audioThreadBusy.store(false);
+    }
+
+    //allocationLock held
+    void allocate()
+    {
+        if (capacity == 0) //not prepared yet, prepare() allocates
+            return;
+
+        release();
+
+        active = std::make_unique<Storage>(capacity, maxDifferenceLatency);
+        storage.store(active.get());
+    }
+
+    /*
+     allocationLock held. New blocks and passes see no storage from here on;
+     one the audio thread or the reader already started gets a short bounded
+     wait, storage still in use after it stays retired until a later call.
+     */
+    void release()
+    {
+        storage.store(nullptr);
+        if (active != nullptr)
+            retired.push_back(std::move(active));
+
+        freeRetired(releaseWaitMilliseconds);
+    }
+
+    //allocationLock held; retired storage is free to go once neither thread is inside a block or a pass
+    void freeRetired(int timeoutMilliseconds)
+    {
+        if (retired.empty())
+            return;
+
+        const auto deadline = juce::Time::getMillisecondCounter() + (juce::uint32)timeoutMilliseconds;
+        while (audioThreadBusy.load() || readerBusy.load())
+        {
+            if (juce::Time::getMillisecondCounter() >= deadline)
+                return;
+
+            juce::Thread::yield();
+        }
+
+        retired.clear();
+    }
+
+    //from the pre samples already in the ring, through the delay line while the EQ has latency
+    void writeDifference(const juce::AudioBuffer<float>& buffer)
+    {
+        const auto numSamples = buffer.getNumSamples();
+        auto& preDelay = block->preDelay;
+        auto& preDelayLength = block->preDelayLength;
+        auto& preDelayPosition = block->preDelayPosition;
+
+        //a new latency or a gap in the history starts from silence, the old samples don't line up
+        if (const auto latency = differenceLatency.load(); latency != preDelayLength || !block->preDelayValid)
+        {
+            preDelayLength = latency;
+            preDelayPosition = 0;
+            preDelay.clear();
+            block->preDelayValid = true;
+        }
+
+        int start1, size1, start2, size2;
+        block->fifo.prepareToWrite(numSamples, start1, size1, start2, size2);
+
+        for (int channel = 0; channel < 2; ++channel)
+        {
+            const auto* post = getInputChannel(buffer, channel);
+            const auto* pre = block->ring.getReadPointer(AnalyzerTap_Pre * 2 + channel);
+            auto* difference = block->ring.getWritePointer(AnalyzerTap_Difference * 2 + channel);
+
+            if (preDelayLength == 0)
+            {
+                if (size1 > 0)
+                    juce::FloatVectorOperations::subtract(difference + start1, post, pre + start1, size1);
+                if (size2 > 0)
+                    juce::FloatVectorOperations::subtract(difference + start2, post + size1, pre + start2, size2);
+                continue;
+            }
+
+            auto* line = preDelay.getWritePointer(channel);
+            auto position = preDelayPosition;
+
+            for (int i = 0; i < size1 + size2; ++i)
+            {
+                const auto index = i < size1 ? start1 + i : start2 + i - size1;
+                const auto delayed = line[position];
+                line[position] = pre[index];
+                difference[index] = post[i] - delayed;
+
+                if (++position == preDelayLength)
+                    position = 0;
+            }
+        }
+
+        if (preDelayLength > 0)
+            preDelayPosition = (preDelayPosition + numSamples) % preDelayLength;
+    }
+
+    //mono input feeds both channels of a tap
+    static const float* getInputChannel(const juce::AudioBuffer<float>& buffer, int channel)
+    {
+        return buffer.getReadPointer(buffer.getNumChannels() > 1 ? channel : 0);
+    }
+
+    //into the space reserved for the current block, nothing is committed yet
+    void write(AnalyzerTap tap, const juce::AudioBuffer<float>& buffer)
+    {
+        int start1, size1, start2, size2;
+        block->fifo.prepareToWrite(buffer.getNumSamples(), start1, size1, start2, size2);
+
+        for (int channel = 0; channel < 2; ++channel)
+        {
+            const auto* source = getInputChannel(buffer, channel);
+            auto* dest = block->ring.getWritePointer(tap * 2 + channel);
+
+            if (size1 > 0)
+                juce::FloatVectorOperations::copy(dest + start1, source, size1);
+            if (size2 > 0)
+                juce::FloatVectorOperations::copy(dest + start2, source + size1, size2);
+        }
+    }
+
+    //a block or an analyzer pass, whichever is longer, well within this
+    static constexpr int releaseWaitMilliseconds = 50;
+
+    //allocationLock held for all but the pointers the two threads pin
+    std::unique_ptr<Storage> active;
+    std::vector<std::unique_ptr<Storage>> retired;
+    std::atomic<Storage*> storage{nullptr};
+    Storage* block = nullptr; //audio thread, from capturePre to publishPost
+    Storage* readerStorage = nullptr; //reader, inside a ScopedRead
+
+    std::array<std::atomic<int>, numTaps> listeners{};
+    int blockTaps = 0;
+    int capacity = 0;
+    std::atomic<int> maxDifferenceLatency{0};
+    std::atomic<int> differenceLatency{0};
+
+    std::atomic<bool> audioThreadBusy{false}, readerBusy{false};
+    juce::CriticalSection allocationLock;
+};
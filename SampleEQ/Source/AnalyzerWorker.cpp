@@ -0,0 +1,56 @@
+/*
+  ==============================================================================
+
+    AnalyzerWorker.cpp
+    Created: 19 Oct 2026 6:02:41pm
+    Author:  tyzTang
+
+  ==============================================================================
+*/
+
+#include "AnalyzerWorker.h"
+
+AnalyzerWorker::AnalyzerWorker() : juce::Thread("SampleEQ Analyzer")
+{
+    startThread(juce::Thread::Priority::low);
+}
+
+AnalyzerWorker::~AnalyzerWorker()
+{
+    stopThread(1000);
+}
+
+void AnalyzerWorker::addClient(Client* client)
+{
+    const juce::ScopedLock sl(clientLock);
+    clients.addIfNotAlreadyThere(client);
+}
+
+void AnalyzerWorker::removeClient(Client* client)
+{
+    //clientLock is held while a client runs, so this waits for it to finish
+    const juce::ScopedLock sl(clientLock);
+    clients.removeFirstMatchingValue(client);
+}
+
+void AnalyzerWorker::run()
+{
+    while (!threadShouldExit())
+    {
+        {
+            const juce::ScopedLock sl(clientLock);
+
+            const auto numClients = clients.size();
+            if (numClients > 0)
+            {
+                //every client gets to go first in turn
+                nextClient = (nextClient + 1) % numClients;
+
+                for (int i = 0; i < numClients && !threadShouldExit(); ++i)
+                    clients.getUnchecked((nextClient + i) % numClients)->analyse();
+            }
+        }
+
+        wait(intervalMilliseconds);
+    }
+}
@@ -0,0 +1,50 @@
+/*
+  ==============================================================================
+
+    AnalyzerWorker.h
+    Created: 19 Oct 2026 6:02:41pm
+    Author:  tyzTang
+
+  ==============================================================================
+*/
+
+#pragma once
+#include <JuceHeader.h>
+
+/*
+ One analysis thread for the whole process, shared by every editor through
+ juce::SharedResourcePointer<AnalyzerWorker>.
+
+ Each pass gives every registered client one analyse() call, starting from a
+ different client every time, so no editor can starve the others. The message
+ thread only picks up the finished results.
+ */
+class AnalyzerWorker : private juce::Thread
+{
+public:
+    struct Client
+    {
+        virtual ~Client() = default;
+
+        //worker thread: drain the input, run the FFTs, build the render data
+        virtual void analyse() = 0;
+    };
+
+    AnalyzerWorker();
+    ~AnalyzerWorker() override;
+
+    //message thread; removeClient() returns once the client is no longer running
+    void addClient(Client* client);
+    void removeClient(Client* client);
+
+    static constexpr int intervalMilliseconds = 8;
+
+private:
+    void run() override;
+
+    juce::CriticalSection clientLock;
+    juce::Array<Client*> clients;
+    int nextClient = 0;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(AnalyzerWorker)
+};
@@ -0,0 +1,61 @@
+/*
+  ==============================================================================
+
+    AutoGain.cpp
+    Created: 19 Oct 2026 11:48:31am
+    Author:  tyzTang
+
+  ==============================================================================
+*/
+
+#include "AutoGain.h"
+
+AutoGain::AutoGain() : frequencies(FilterResponse::makeLogFrequencies(numPoints))
+{
+    //BS.1770 pre-filter and RLB high-pass, evaluated at their 48kHz reference rate
+    constexpr double referenceRate = 48000.0;
+    FilterResponse kResponse;
+    kResponse.setFrequencies(frequencies, referenceRate);
+
+    auto shelf = juce::dsp::IIR::Coefficients<float>::makeHighShelf(
+        referenceRate, 1681.974450955533, 0.7071752369554196,
+        juce::Decibels::decibelsToGain(3.999843853973347f));
+    auto highPass = juce::dsp::IIR::Coefficients<float>::makeHighPass(
+        referenceRate, 38.13547087602444, 0.5003270373238773);
+
+    kWeights.assign(frequencies.size(), 1.0);
+    kResponse.multiplyMagnitudeSquared(*shelf, kWeights.data());
+    kResponse.multiplyMagnitudeSquared(*highPass, kWeights.data());
+
+    response.setFrequencies(frequencies, referenceRate);
+}
+
+void AutoGain::prepare(double sampleRate)
+{
+    response.setFrequencies(frequencies, sampleRate);
+}
+
+float AutoGain::getCompensation(const std::vector<double>& magnitudesSquared, AutoGainMode mode) const
+{
+    if (mode == AutoGain_Off)
+        return 1.f;
+
+    jassert(magnitudesSquared.size() == frequencies.size());
+
+    double weightedPower = 0.0, totalWeight = 0.0;
+    for (size_t i = 0; i < frequencies.size(); ++i)
+    {
+        auto w = mode == AutoGain_KWeighted ? kWeights[i] : 1.0;
+        weightedPower += w * magnitudesSquared[i];
+        totalWeight += w;
+    }
+
+    if (weightedPower <= 0.0 || totalWeight <= 0.0)
+        return 1.f;
+
+    auto compensationInDecibels = (float)(-10.0 * std::log10(weightedPower / totalWeight));
+    compensationInDecibels = juce::jlimit(-maxCompensationInDecibels, maxCompensationInDecibels,
+                                          compensationInDecibels);
+
+    return juce::Decibels::decibelsToGain(compensationInDecibels);
+}
@@ -0,0 +1,52 @@
+/*
+  ==============================================================================
+
+    AutoGain.h
+    Created: 19 Oct 2026 11:48:31am
+    Author:  tyzTang
+
+  ==============================================================================
+*/
+
+#pragma once
+#include <JuceHeader.h>
+
+#include "FilterResponse.h"
+
+enum AutoGainMode
+{
+    AutoGain_Off,
+    AutoGain_Pink,
+    AutoGain_KWeighted,
+};
+
+/*
+ Level compensation predicted from the magnitude response alone.
+
+ The reference is pink noise (equal power per octave, so uniform weights on a
+ log grid), optionally shaped by the BS.1770 K-weighting curve.
+ Compensation = 1 / sqrt(sum(w |H|^2) / sum(w)), no audio is measured.
+ */
+class AutoGain
+{
+public:
+    AutoGain();
+
+    //updates the filter evaluation grid, the weights don't depend on the sample rate
+    void prepare(double sampleRate);
+
+    const FilterResponse& getResponse() const { return response; }
+    const std::vector<double>& getFrequencies() const { return frequencies; }
+    int getNumPoints() const { return numPoints; }
+
+    //magnitudesSquared holds |H|^2 on getFrequencies(), returns a linear gain
+    float getCompensation(const std::vector<double>& magnitudesSquared, AutoGainMode mode) const;
+
+    static constexpr int numPoints = 128;
+    static constexpr float maxCompensationInDecibels = 24.f;
+
+private:
+    const std::vector<double> frequencies;
+    std::vector<double> kWeights;
+    FilterResponse response;
+};
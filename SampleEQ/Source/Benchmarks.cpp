@@ -0,0 +1,266 @@
+/*
+  ==============================================================================
+
+    Benchmarks.cpp
+    Created: 19 Oct 2026 5:31:08pm
+    Author:  tyzTang
+
+  ==============================================================================
+*/
+
+#include "Benchmarks.h"
+#include "DspKernels.h"
+#include "FFTEngine.h"
+#include "SingleChannelSampleFifo.h"
+
+namespace
+{
+    //Msamples/s of 'numRuns' calls over 'numSamples' samples each
+    template <typename Function>
+    double measure(int numSamples, int numRuns, Function&& function)
+    {
+        //first call warms the caches and the dispatch
+        function();
+
+        const auto start = juce::Time::getHighResolutionTicks();
+        for (int run = 0; run < numRuns; ++run)
+            function();
+        const auto seconds = juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - start);
+
+        return (double)numSamples * numRuns / juce::jmax(seconds, 1.0e-9) * 1.0e-6;
+    }
+
+    //average us per call of 'function'
+    template <typename Function>
+    double measureMicroseconds(int numRuns, Function&& function)
+    {
+        return 1.0 / measure(1, numRuns, function);
+    }
+
+    juce::String formatRate(double rate)
+    {
+        return juce::String(rate, 1) + " Msamples/s";
+    }
+
+    //the original per-sample, copy-on-push SingleChannelSampleFifo::update, kept as the baseline
+    struct PerSampleFifo
+    {
+        void prepare(int bufferSize)
+        {
+            bufferToFill.setSize(1, bufferSize);
+            fifo.prepare(1, bufferSize);
+            fifoIndex = 0;
+        }
+
+        void update(const juce::AudioBuffer<float>& buffer)
+        {
+            auto* channelPtr = buffer.getReadPointer(0);
+
+            for (int i = 0; i < buffer.getNumSamples(); ++i)
+            {
+                if (fifoIndex == bufferToFill.getNumSamples())
+                {
+                    fifo.push(bufferToFill);
+                    fifoIndex = 0;
+                }
+
+                bufferToFill.setSample(0, fifoIndex, channelPtr[i]);
+                ++fifoIndex;
+            }
+        }
+
+        void drain()
+        {
+            while (fifo.pull(drained)) {}
+        }
+
+        Fifo<juce::AudioBuffer<float>> fifo;
+        juce::AudioBuffer<float> bufferToFill, drained;
+        int fifoIndex = 0;
+    };
+
+    void drain(PerSampleFifo& fifo) { fifo.drain(); }
+
+    void drain(SingleChannelSampleFifo<juce::AudioBuffer<float>>& fifo)
+    {
+        while (fifo.acquireAudioBuffer() != nullptr)
+            fifo.releaseAudioBuffer();
+    }
+
+    //average ns per update() call, the consumer side is drained outside the timed region
+    template <typename FifoType>
+    double measureUpdate(FifoType& fifo, const juce::AudioBuffer<float>& block, int numBlocks)
+    {
+        juce::int64 ticks = 0;
+
+        for (int i = 0; i < numBlocks; ++i)
+        {
+            const auto start = juce::Time::getHighResolutionTicks();
+            fifo.update(block);
+            ticks += juce::Time::getHighResolutionTicks() - start;
+
+            drain(fifo);
+        }
+
+        return juce::Time::highResolutionTicksToSeconds(ticks) / numBlocks * 1.0e9;
+    }
+}
+
+namespace Benchmarks
+{
+    juce::String runDspKernelBenchmarks(int numSamples, int numRuns)
+    {
+        juce::Random random;
+        std::vector<float> data((size_t)numSamples), window((size_t)numSamples), left((size_t)numSamples), right((size_t)numSamples);
+
+        for (auto* samples : {&data, &window, &left, &right})
+            for (auto& sample : *samples)
+                sample = random.nextFloat() * 2.f - 1.f;
+
+        //every stage active, the worst case of the biquad path
+        StereoBiquadCascade cascade;
+        auto peak = juce::dsp::IIR::Coefficients<float>::makePeakFilter(48000.0, 1000.f, 1.f, 2.f);
+        for (int stage = 0; stage < StereoBiquadCascade::maxStages; ++stage)
+        {
+            std::copy(peak->getRawCoefficients(), peak->getRawCoefficients() + 5, cascade.coefficients[stage].begin());
+            cascade.activeStages[stage] = stage;
+        }
+        cascade.numActiveStages = StereoBiquadCascade::maxStages;
+
+        juce::String report;
+        report << "DspKernels, " << numSamples << " samples x " << numRuns << " runs" << juce::newLine;
+
+        for (auto level : {SimdLevel::Scalar, SimdLevel::SSE2, SimdLevel::AVX2, SimdLevel::AVX512})
+        {
+            if (!isSimdLevelSupported(level))
+            {
+                report << "  " << getSimdLevelName(level) << ": not supported" << juce::newLine;
+                continue;
+            }
+
+            const auto& kernels = getDspKernels(level);
+            auto scratch = data;
+
+            auto multiply = measure(numSamples, numRuns, [&]
+            {
+                kernels.multiply(scratch.data(), window.data(), numSamples);
+            });
+
+            auto decibels = measure(numSamples, numRuns, [&]
+            {
+                std::copy(data.begin(), data.end(), scratch.begin());
+                kernels.magnitudesToDecibels(scratch.data(), numSamples, 1.f / (float)numSamples, -48.f);
+            });
+
+            std::vector<float> averagingState((size_t)numSamples, 0.f);
+            auto average = measure(numSamples, numRuns, [&]
+            {
+                std::copy(data.begin(), data.end(), scratch.begin());
+                kernels.averagePowerToDecibels(scratch.data(), averagingState.data(), numSamples,
+                                               1.f / (float)numSamples, 0.1f, -48.f);
+            });
+
+            cascade.reset();
+            auto biquads = measure(numSamples, numRuns, [&]
+            {
+                kernels.biquadCascade(left.data(), right.data(), numSamples, cascade);
+            });
+
+            report << "  " << kernels.name
+                << ": window " << formatRate(multiply)
+                << ", dB " << formatRate(decibels)
+                << ", averaged dB " << formatRate(average)
+                << ", 9 stereo biquads " << formatRate(biquads)
+                << juce::newLine;
+        }
+
+        return report;
+    }
+
+    juce::String runSampleFifoBenchmarks(int numBlocks)
+    {
+        juce::String report;
+        report << "SingleChannelSampleFifo::update, fifo buffer = host block" << juce::newLine;
+
+        for (auto blockSize : {32, 64, 128, 256, 512, 1024})
+        {
+            juce::AudioBuffer<float> block(2, blockSize);
+            juce::Random random;
+            for (int i = 0; i < blockSize; ++i)
+                block.setSample(0, i, random.nextFloat() * 2.f - 1.f);
+
+            PerSampleFifo before;
+            before.prepare(blockSize);
+            SingleChannelSampleFifo<juce::AudioBuffer<float>> after{Channel::Right};
+            after.prepare(blockSize);
+
+            //warm up both, then time them
+            measureUpdate(before, block, 16);
+            measureUpdate(after, block, 16);
+            const auto beforeNs = measureUpdate(before, block, numBlocks);
+            const auto afterNs = measureUpdate(after, block, numBlocks);
+
+            report << "  " << blockSize << " samples: per-sample " << juce::String(beforeNs, 0)
+                << " ns, block copy " << juce::String(afterNs, 0) << " ns ("
+                << juce::String(beforeNs / juce::jmax(afterNs, 1.0), 1) << "x)" << juce::newLine;
+        }
+
+        return report;
+    }
+
+    juce::String runFFTBenchmarks(int numRuns)
+    {
+        juce::String report;
+        report << "FFTEngine, stereo analyzer frame, " << getDspKernels().name << " kernels" << juce::newLine;
+
+        for (int order = order512; order <= order16384; ++order)
+        {
+            const auto fftSize = 1 << order;
+            const auto numBins = fftSize / 2;
+
+            juce::Random random;
+            juce::AudioBuffer<float> audio(2, fftSize);
+            for (int channel = 0; channel < 2; ++channel)
+                for (int i = 0; i < fftSize; ++i)
+                    audio.setSample(channel, i, random.nextFloat() * 2.f - 1.f);
+
+            std::vector<float> window((size_t)fftSize), frame((size_t)fftSize);
+            juce::dsp::WindowingFunction<float>::fillWindowingTables(
+                window.data(), (size_t)fftSize, juce::dsp::WindowingFunction<float>::blackmanHarris);
+
+            double microseconds[2]{};
+
+            for (auto backend : {FFTBackend_Juce, FFTBackend_BuiltIn})
+            {
+                auto engine = createFFTEngine(backend, order);
+
+                microseconds[backend] = measureMicroseconds(numRuns, [&]
+                {
+                    engine->transform(audio.getReadPointer(0), audio.getReadPointer(1), window.data());
+
+                    for (int channel = 0; channel < 2; ++channel)
+                        for (int startBin = 0; startBin < numBins; startBin += FFTEngine::binsPerRun)
+                            engine->getMagnitudes(channel, frame.data() + channel * numBins + startBin, startBin,
+                                                  juce::jmin(FFTEngine::binsPerRun, numBins - startBin));
+                });
+            }
+
+            //the timing only counts if the output matches juce::dsp::FFT
+            const auto deviation = getFFTDeviation(FFTBackend_BuiltIn, order);
+            jassert(deviation <= maxFFTDeviation);
+
+            report << "  order " << order << " (" << fftSize << "): "
+                << getFFTBackendName(FFTBackend_Juce) << " " << juce::String(microseconds[FFTBackend_Juce], 1) << " us, "
+                << getFFTBackendName(FFTBackend_BuiltIn) << " " << juce::String(microseconds[FFTBackend_BuiltIn], 1) << " us ("
+                << juce::String(microseconds[FFTBackend_Juce] / juce::jmax(microseconds[FFTBackend_BuiltIn], 1.0e-3), 1)
+                << "x), max deviation " << juce::String(deviation, 8) << juce::newLine;
+        }
+
+        return report;
+    }
+
+    juce::String runAll()
+    {
+        return runDspKernelBenchmarks() + runSampleFifoBenchmarks() + runFFTBenchmarks();
+    }
+}
@@ -0,0 +1,33 @@
+/*
+  ==============================================================================
+
+    Benchmarks.h
+    Created: 19 Oct 2026 5:31:08pm
+    Author:  tyzTang
+
+  ==============================================================================
+*/
+
+#pragma once
+#include <JuceHeader.h>
+
+/*
+ Throughput of the hot paths, one line per variant.
+ Not part of the plugin's normal startup, build with SAMPLEEQ_RUN_BENCHMARKS=1
+ to have the processor write the report to the log when it's created.
+ */
+namespace Benchmarks
+{
+    //every DspKernels variant the CPU supports
+    juce::String runDspKernelBenchmarks(int numSamples = 8192, int numRuns = 500);
+
+    //audio thread cost of SingleChannelSampleFifo::update per host block, per-sample loop vs span copies
+    juce::String runSampleFifoBenchmarks(int numBlocks = 2000);
+
+    //one stereo analyzer frame (transform and magnitudes) per FFTBackend at every FFTOrder,
+    //with the built-in engine's largest magnitude deviation from juce::dsp::FFT
+    juce::String runFFTBenchmarks(int numRuns = 200);
+
+    //all of the above
+    juce::String runAll();
+}
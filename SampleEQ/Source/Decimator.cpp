@@ -0,0 +1,86 @@
+/*
+  ==============================================================================
+
+    Decimator.cpp
+    Created: 19 Oct 2026 10:48:20pm
+    Author:  tyzTang
+
+  ==============================================================================
+*/
+
+#include "Decimator.h"
+
+void Decimator::prepare(int numChannels, int newFactor, int tapsPerPhase, double cutoff)
+{
+    factor = juce::jmax(1, newFactor);
+    numTaps = factor * tapsPerPhase;
+
+    //Blackman window, ~75 dB stopband, unity gain at DC
+    std::vector<double> taps((size_t)numTaps);
+    const auto centre = 0.5 * (numTaps - 1);
+    double sum = 0.0;
+
+    for (int i = 0; i < numTaps; ++i)
+    {
+        const auto x = i - centre;
+        const auto sinc = x == 0.0 ? 2.0 * cutoff
+                                   : std::sin(juce::MathConstants<double>::twoPi * cutoff * x)
+                                         / (juce::MathConstants<double>::pi * x);
+        const auto phaseOfWindow = juce::MathConstants<double>::twoPi * i / (numTaps - 1);
+        const auto window = 0.42 - 0.5 * std::cos(phaseOfWindow) + 0.08 * std::cos(2.0 * phaseOfWindow);
+
+        taps[(size_t)i] = sinc * window;
+        sum += taps[(size_t)i];
+    }
+
+    reversedTaps.resize((size_t)numTaps);
+    for (int i = 0; i < numTaps; ++i)
+        reversedTaps[(size_t)i] = (float)(taps[(size_t)(numTaps - 1 - i)] / sum);
+
+    delayLines.setSize(numChannels, 2 * numTaps);
+    reset();
+}
+
+void Decimator::reset()
+{
+    delayLines.clear();
+    phase = 0;
+    writePosition = 0;
+}
+
+int Decimator::process(const float* const* input, int numSamples, float* const* output)
+{
+    int numOut = 0;
+
+    for (int i = 0; i < numSamples; ++i)
+    {
+        for (int channel = 0; channel < delayLines.getNumChannels(); ++channel)
+        {
+            auto* line = delayLines.getWritePointer(channel);
+            line[writePosition] = line[writePosition + numTaps] = input[channel][i];
+        }
+
+        writePosition = writePosition + 1 == numTaps ? 0 : writePosition + 1;
+
+        if (++phase < factor)
+            continue;
+
+        phase = 0;
+
+        //the window [writePosition, writePosition + numTaps) runs from the oldest to the newest sample
+        for (int channel = 0; channel < delayLines.getNumChannels(); ++channel)
+        {
+            const auto* window = delayLines.getReadPointer(channel, writePosition);
+
+            float sum = 0.f;
+            for (int tap = 0; tap < numTaps; ++tap)
+                sum += reversedTaps[(size_t)tap] * window[tap];
+
+            output[channel][numOut] = sum;
+        }
+
+        ++numOut;
+    }
+
+    return numOut;
+}
@@ -0,0 +1,49 @@
+/*
+  ==============================================================================
+
+    Decimator.h
+    Created: 19 Oct 2026 10:48:20pm
+    Author:  tyzTang
+
+  ==============================================================================
+*/
+
+#pragma once
+#include <JuceHeader.h>
+
+/*
+ Windowed-sinc lowpass and downsampling by an integer factor, for the
+ analyzer bands that only need the low end.
+
+ Polyphase: only every factor-th output is computed, so a sample costs
+ tapsPerPhase multiply-adds per channel whatever the factor. The delay line
+ of each channel is kept twice in a row, so every output reads one
+ contiguous window without wrapping.
+ */
+class Decimator
+{
+public:
+    //'cutoff' as a fraction of the input sample rate, the filter has factor * tapsPerPhase taps
+    void prepare(int numChannels, int factor, int tapsPerPhase, double cutoff);
+    void reset();
+
+    int getFactor() const { return factor; }
+
+    size_t getMemoryUsage() const
+    {
+        return (reversedTaps.capacity() + (size_t)delayLines.getNumChannels() * (size_t)delayLines.getNumSamples())
+               * sizeof(float);
+    }
+
+    //at most numSamples / factor + 1 samples per channel are written to 'output', returns how many
+    int process(const float* const* input, int numSamples, float* const* output);
+
+private:
+    int factor = 1;
+    int numTaps = 0;
+    int phase = 0;
+    int writePosition = 0;
+
+    std::vector<float> reversedTaps; //h[numTaps - 1 - i], lined up with the oldest-first window
+    juce::AudioBuffer<float> delayLines; //2 * numTaps per channel
+};
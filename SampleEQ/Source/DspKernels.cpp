@@ -0,0 +1,854 @@
+/*
+  ==============================================================================
+
+    DspKernels.cpp
+    Created: 19 Oct 2026 4:40:13pm
+    Author:  tyzTang
+
+  ==============================================================================
+*/
+
+#include "DspKernels.h"
+
+#if JUCE_INTEL
+ #include <immintrin.h>
+ #if JUCE_MSVC
+  #define DSP_TARGET(isa)
+ #else
+  #define DSP_TARGET(isa) __attribute__((target(isa)))
+ #endif
+#endif
+
+namespace
+{
+    //20 * log10(2) and 10 * log10(2), the vector paths work in log2
+    constexpr float decibelsPerOctave = 6.0205999f;
+    constexpr float powerDecibelsPerOctave = 3.0103f;
+    constexpr float smallestGain = 1.0e-30f;
+
+    //log2(1 + t) on [0, 1), least squares fit, < 0.0002 dB error
+    constexpr float log2C1 = 1.4418259f, log2C2 = -0.7086829f, log2C3 = 0.4154247f,
+                    log2C4 = -0.1944264f, log2C5 = 0.0458872f;
+
+#pragma region Scalar
+
+    void multiplyScalar(float* data, const float* window, int num)
+    {
+        for (int i = 0; i < num; ++i)
+            data[i] *= window[i];
+    }
+
+    void magnitudesToDecibelsScalar(float* data, int num, float scale, float negativeInfinity)
+    {
+        for (int i = 0; i < num; ++i)
+        {
+            auto v = data[i];
+            data[i] = std::isfinite(v) ? juce::Decibels::gainToDecibels(v * scale, negativeInfinity)
+                                       : negativeInfinity;
+        }
+    }
+
+    void averagePowerToDecibelsScalar(float* data, float* state, int num, float scale, float weight,
+                                      float negativeInfinity)
+    {
+        for (int i = 0; i < num; ++i)
+        {
+            auto v = data[i] * scale;
+            auto power = std::isfinite(v) ? v * v : 0.f;
+            auto average = state[i] + weight * (power - state[i]);
+
+            state[i] = average;
+            data[i] = average > 0.f ? juce::jmax(negativeInfinity, 10.f * std::log10(average)) : negativeInfinity;
+        }
+    }
+
+    void peakHoldToDecibelsScalar(float* data, float* state, int num, float scale, float decayInDecibels,
+                                  float negativeInfinity)
+    {
+        for (int i = 0; i < num; ++i)
+        {
+            auto v = data[i];
+            auto decibels = std::isfinite(v) ? juce::Decibels::gainToDecibels(v * scale, negativeInfinity)
+                                             : negativeInfinity;
+            auto held = juce::jmax(decibels, state[i] - decayInDecibels, negativeInfinity);
+
+            state[i] = held;
+            data[i] = held;
+        }
+    }
+
+    void biquadCascadeScalar(float* left, float* right, int numSamples, StereoBiquadCascade& cascade)
+    {
+        for (int n = 0; n < cascade.numActiveStages; ++n)
+        {
+            const auto stage = cascade.activeStages[n];
+            const auto& c = cascade.coefficients[stage];
+            auto* z = cascade.state[stage];
+
+            float* channels[] = {left, right};
+            for (int ch = 0; ch < 2; ++ch)
+            {
+                auto* data = channels[ch];
+                auto z1 = z[ch], z2 = z[ch + 2];
+
+                for (int i = 0; i < numSamples; ++i)
+                {
+                    auto x = data[i];
+                    auto y = c[0] * x + z1;
+                    z1 = c[1] * x - c[3] * y + z2;
+                    z2 = c[2] * x - c[4] * y;
+                    data[i] = y;
+                }
+
+                z[ch] = z1;
+                z[ch + 2] = z2;
+            }
+        }
+    }
+
+    void fftRadix4PassScalar(const float* xr, const float* xi, float* yr, float* yi, int n, int s, const float* twiddles)
+    {
+        const int n1 = n / 4;
+        const auto* w1r = twiddles;
+        const auto* w1i = twiddles + n1;
+        const auto* w2r = twiddles + 2 * n1;
+        const auto* w2i = twiddles + 3 * n1;
+        const auto* w3r = twiddles + 4 * n1;
+        const auto* w3i = twiddles + 5 * n1;
+
+        for (int p = 0; p < n1; ++p)
+        {
+            for (int q = 0; q < s; ++q)
+            {
+                const int in = q + s * p;
+                const int out = q + s * 4 * p;
+
+                const auto ar = xr[in], ai = xi[in];
+                const auto br = xr[in + s * n1], bi = xi[in + s * n1];
+                const auto cr = xr[in + 2 * s * n1], ci = xi[in + 2 * s * n1];
+                const auto dr = xr[in + 3 * s * n1], di = xi[in + 3 * s * n1];
+
+                const auto apcR = ar + cr, apcI = ai + ci, amcR = ar - cr, amcI = ai - ci;
+                const auto bpdR = br + dr, bpdI = bi + di, bmdR = br - dr, bmdI = bi - di;
+
+                //a + c + b + d, (a - c - j(b - d)) w, (a + c - b - d) w^2, (a - c + j(b - d)) w^3
+                const auto u1r = amcR + bmdI, u1i = amcI - bmdR;
+                const auto u2r = apcR - bpdR, u2i = apcI - bpdI;
+                const auto u3r = amcR - bmdI, u3i = amcI + bmdR;
+
+                yr[out] = apcR + bpdR;
+                yi[out] = apcI + bpdI;
+                yr[out + s] = w1r[p] * u1r - w1i[p] * u1i;
+                yi[out + s] = w1r[p] * u1i + w1i[p] * u1r;
+                yr[out + 2 * s] = w2r[p] * u2r - w2i[p] * u2i;
+                yi[out + 2 * s] = w2r[p] * u2i + w2i[p] * u2r;
+                yr[out + 3 * s] = w3r[p] * u3r - w3i[p] * u3i;
+                yi[out + 3 * s] = w3r[p] * u3i + w3i[p] * u3r;
+            }
+        }
+    }
+
+    void realFFTMagnitudesScalar(const float* zr, const float* zi, const float* twiddles, float* dest, int m,
+                                 int startBin, int numBins)
+    {
+        for (int i = 0; i < numBins; ++i)
+        {
+            const int k = startBin + i;
+            const int mirrored = (m - k) & (m - 1);
+
+            //even and odd samples' spectra from Z[k] and conj(Z[m - k]), then X[k] = E + exp(-pi j k / m) O
+            const auto er = 0.5f * (zr[k] + zr[mirrored]), ei = 0.5f * (zi[k] - zi[mirrored]);
+            const auto orr = 0.5f * (zi[k] + zi[mirrored]), oi = 0.5f * (zr[mirrored] - zr[k]);
+            const auto wr = twiddles[k], wi = -twiddles[m + k];
+
+            const auto re = er + wr * orr - wi * oi;
+            const auto im = ei + wr * oi + wi * orr;
+            dest[i] = std::sqrt(re * re + im * im);
+        }
+    }
+
+#pragma endregion
+
+#if JUCE_INTEL
+
+#pragma region SSE2
+
+    DSP_TARGET("sse2") inline __m128 log2SSE2(__m128 x)
+    {
+        const auto bits = _mm_castps_si128(x);
+        const auto exponent = _mm_cvtepi32_ps(_mm_sub_epi32(_mm_srli_epi32(bits, 23), _mm_set1_epi32(127)));
+        const auto mantissa = _mm_castsi128_ps(_mm_or_si128(_mm_and_si128(bits, _mm_set1_epi32(0x007FFFFF)),
+                                                            _mm_set1_epi32(0x3F800000)));
+        const auto t = _mm_sub_ps(mantissa, _mm_set1_ps(1.f));
+
+        auto p = _mm_set1_ps(log2C5);
+        p = _mm_add_ps(_mm_mul_ps(p, t), _mm_set1_ps(log2C4));
+        p = _mm_add_ps(_mm_mul_ps(p, t), _mm_set1_ps(log2C3));
+        p = _mm_add_ps(_mm_mul_ps(p, t), _mm_set1_ps(log2C2));
+        p = _mm_add_ps(_mm_mul_ps(p, t), _mm_set1_ps(log2C1));
+        return _mm_add_ps(exponent, _mm_mul_ps(p, t));
+    }
+
+    DSP_TARGET("sse2") void multiplySSE2(float* data, const float* window, int num)
+    {
+        int i = 0;
+        for (; i + 4 <= num; i += 4)
+            _mm_storeu_ps(data + i, _mm_mul_ps(_mm_loadu_ps(data + i), _mm_loadu_ps(window + i)));
+
+        multiplyScalar(data + i, window + i, num - i);
+    }
+
+    //dB of already scaled magnitudes, non-finite -> floorV
+    DSP_TARGET("sse2") inline __m128 decibelsSSE2(__m128 v, __m128 floorV)
+    {
+        const auto finite = _mm_cmplt_ps(_mm_and_ps(v, _mm_castsi128_ps(_mm_set1_epi32(0x7FFFFFFF))),
+                                         _mm_set1_ps(std::numeric_limits<float>::infinity()));
+        const auto db = _mm_max_ps(_mm_mul_ps(log2SSE2(_mm_max_ps(v, _mm_set1_ps(smallestGain))),
+                                              _mm_set1_ps(decibelsPerOctave)), floorV);
+        //NaN compares false, so it lands on the floor like +-inf
+        return _mm_or_ps(_mm_and_ps(finite, db), _mm_andnot_ps(finite, floorV));
+    }
+
+    DSP_TARGET("sse2") void magnitudesToDecibelsSSE2(float* data, int num, float scale, float negativeInfinity)
+    {
+        const auto scaleV = _mm_set1_ps(scale);
+        const auto floorV = _mm_set1_ps(negativeInfinity);
+
+        int i = 0;
+        for (; i + 4 <= num; i += 4)
+            _mm_storeu_ps(data + i, decibelsSSE2(_mm_mul_ps(_mm_loadu_ps(data + i), scaleV), floorV));
+
+        magnitudesToDecibelsScalar(data + i, num - i, scale, negativeInfinity);
+    }
+
+    DSP_TARGET("sse2") void averagePowerToDecibelsSSE2(float* data, float* state, int num, float scale, float weight,
+                                                       float negativeInfinity)
+    {
+        const auto scaleV = _mm_set1_ps(scale);
+        const auto weightV = _mm_set1_ps(weight);
+        const auto floorV = _mm_set1_ps(negativeInfinity);
+        const auto infinity = _mm_set1_ps(std::numeric_limits<float>::infinity());
+        const auto absMask = _mm_castsi128_ps(_mm_set1_epi32(0x7FFFFFFF));
+        const auto smallest = _mm_set1_ps(smallestGain);
+        const auto toDecibels = _mm_set1_ps(powerDecibelsPerOctave);
+
+        int i = 0;
+        for (; i + 4 <= num; i += 4)
+        {
+            auto v = _mm_mul_ps(_mm_loadu_ps(data + i), scaleV);
+            auto power = _mm_and_ps(_mm_cmplt_ps(_mm_and_ps(v, absMask), infinity), _mm_mul_ps(v, v));
+
+            auto average = _mm_loadu_ps(state + i);
+            average = _mm_add_ps(average, _mm_mul_ps(weightV, _mm_sub_ps(power, average)));
+            _mm_storeu_ps(state + i, average);
+
+            auto db = _mm_mul_ps(log2SSE2(_mm_max_ps(average, smallest)), toDecibels);
+            _mm_storeu_ps(data + i, _mm_max_ps(db, floorV));
+        }
+
+        averagePowerToDecibelsScalar(data + i, state + i, num - i, scale, weight, negativeInfinity);
+    }
+
+    DSP_TARGET("sse2") void peakHoldToDecibelsSSE2(float* data, float* state, int num, float scale, float decayInDecibels,
+                                                   float negativeInfinity)
+    {
+        const auto scaleV = _mm_set1_ps(scale);
+        const auto decay = _mm_set1_ps(decayInDecibels);
+        const auto floorV = _mm_set1_ps(negativeInfinity);
+
+        int i = 0;
+        for (; i + 4 <= num; i += 4)
+        {
+            auto db = decibelsSSE2(_mm_mul_ps(_mm_loadu_ps(data + i), scaleV), floorV);
+            auto held = _mm_max_ps(db, _mm_max_ps(_mm_sub_ps(_mm_loadu_ps(state + i), decay), floorV));
+            _mm_storeu_ps(state + i, held);
+            _mm_storeu_ps(data + i, held);
+        }
+
+        peakHoldToDecibelsScalar(data + i, state + i, num - i, scale, decayInDecibels, negativeInfinity);
+    }
+
+    //left and right share one register, lanes 2 and 3 are idle
+    DSP_TARGET("sse2") void biquadCascadeSSE2(float* left, float* right, int numSamples, StereoBiquadCascade& cascade)
+    {
+        for (int n = 0; n < cascade.numActiveStages; ++n)
+        {
+            const auto stage = cascade.activeStages[n];
+            const auto& c = cascade.coefficients[stage];
+            auto* z = cascade.state[stage];
+
+            const auto b0 = _mm_set1_ps(c[0]), b1 = _mm_set1_ps(c[1]), b2 = _mm_set1_ps(c[2]);
+            const auto a1 = _mm_set1_ps(c[3]), a2 = _mm_set1_ps(c[4]);
+            auto z1 = _mm_setr_ps(z[0], z[1], 0.f, 0.f);
+            auto z2 = _mm_setr_ps(z[2], z[3], 0.f, 0.f);
+
+            for (int i = 0; i < numSamples; ++i)
+            {
+                auto x = _mm_unpacklo_ps(_mm_load_ss(left + i), _mm_load_ss(right + i));
+                auto y = _mm_add_ps(_mm_mul_ps(b0, x), z1);
+                z1 = _mm_add_ps(_mm_sub_ps(_mm_mul_ps(b1, x), _mm_mul_ps(a1, y)), z2);
+                z2 = _mm_sub_ps(_mm_mul_ps(b2, x), _mm_mul_ps(a2, y));
+
+                _mm_store_ss(left + i, y);
+                _mm_store_ss(right + i, _mm_shuffle_ps(y, y, _MM_SHUFFLE(1, 1, 1, 1)));
+            }
+
+            alignas(16) float stored[4];
+            _mm_store_ps(stored, _mm_movelh_ps(z1, z2));
+            std::copy(stored, stored + 4, z);
+        }
+    }
+
+    //four radix-4 butterflies side by side, outputs overwrite the inputs: a -> y0, b -> y1, c -> y2, d -> y3
+    DSP_TARGET("sse2") inline void radix4SSE2(__m128& ar, __m128& ai, __m128& br, __m128& bi,
+                                              __m128& cr, __m128& ci, __m128& dr, __m128& di,
+                                              __m128 w1r, __m128 w1i, __m128 w2r, __m128 w2i, __m128 w3r, __m128 w3i)
+    {
+        const auto apcR = _mm_add_ps(ar, cr), apcI = _mm_add_ps(ai, ci);
+        const auto amcR = _mm_sub_ps(ar, cr), amcI = _mm_sub_ps(ai, ci);
+        const auto bpdR = _mm_add_ps(br, dr), bpdI = _mm_add_ps(bi, di);
+        const auto bmdR = _mm_sub_ps(br, dr), bmdI = _mm_sub_ps(bi, di);
+
+        const auto u1r = _mm_add_ps(amcR, bmdI), u1i = _mm_sub_ps(amcI, bmdR);
+        const auto u2r = _mm_sub_ps(apcR, bpdR), u2i = _mm_sub_ps(apcI, bpdI);
+        const auto u3r = _mm_sub_ps(amcR, bmdI), u3i = _mm_add_ps(amcI, bmdR);
+
+        ar = _mm_add_ps(apcR, bpdR);
+        ai = _mm_add_ps(apcI, bpdI);
+        br = _mm_sub_ps(_mm_mul_ps(w1r, u1r), _mm_mul_ps(w1i, u1i));
+        bi = _mm_add_ps(_mm_mul_ps(w1r, u1i), _mm_mul_ps(w1i, u1r));
+        cr = _mm_sub_ps(_mm_mul_ps(w2r, u2r), _mm_mul_ps(w2i, u2i));
+        ci = _mm_add_ps(_mm_mul_ps(w2r, u2i), _mm_mul_ps(w2i, u2r));
+        dr = _mm_sub_ps(_mm_mul_ps(w3r, u3r), _mm_mul_ps(w3i, u3i));
+        di = _mm_add_ps(_mm_mul_ps(w3r, u3i), _mm_mul_ps(w3i, u3r));
+    }
+
+    DSP_TARGET("sse2") void fftRadix4PassSSE2(const float* xr, const float* xi, float* yr, float* yi, int n, int s,
+                                              const float* twiddles)
+    {
+        const int n1 = n / 4;
+
+        if (s == 1 && n1 >= 4)
+        {
+            //first pass: four p at a time, the outputs of one p are adjacent so each group is transposed on the way out
+            for (int p = 0; p < n1; p += 4)
+            {
+                auto ar = _mm_loadu_ps(xr + p), ai = _mm_loadu_ps(xi + p);
+                auto br = _mm_loadu_ps(xr + n1 + p), bi = _mm_loadu_ps(xi + n1 + p);
+                auto cr = _mm_loadu_ps(xr + 2 * n1 + p), ci = _mm_loadu_ps(xi + 2 * n1 + p);
+                auto dr = _mm_loadu_ps(xr + 3 * n1 + p), di = _mm_loadu_ps(xi + 3 * n1 + p);
+
+                radix4SSE2(ar, ai, br, bi, cr, ci, dr, di,
+                           _mm_loadu_ps(twiddles + p), _mm_loadu_ps(twiddles + n1 + p),
+                           _mm_loadu_ps(twiddles + 2 * n1 + p), _mm_loadu_ps(twiddles + 3 * n1 + p),
+                           _mm_loadu_ps(twiddles + 4 * n1 + p), _mm_loadu_ps(twiddles + 5 * n1 + p));
+
+                _MM_TRANSPOSE4_PS(ar, br, cr, dr);
+                _MM_TRANSPOSE4_PS(ai, bi, ci, di);
+
+                auto* outR = yr + 4 * p;
+                auto* outI = yi + 4 * p;
+                _mm_storeu_ps(outR, ar);
+                _mm_storeu_ps(outR + 4, br);
+                _mm_storeu_ps(outR + 8, cr);
+                _mm_storeu_ps(outR + 12, dr);
+                _mm_storeu_ps(outI, ai);
+                _mm_storeu_ps(outI + 4, bi);
+                _mm_storeu_ps(outI + 8, ci);
+                _mm_storeu_ps(outI + 12, di);
+            }
+
+            return;
+        }
+
+        if (s < 4)
+        {
+            fftRadix4PassScalar(xr, xi, yr, yi, n, s, twiddles);
+            return;
+        }
+
+        //later passes: s contiguous butterflies share one set of twiddles
+        for (int p = 0; p < n1; ++p)
+        {
+            const auto w1r = _mm_set1_ps(twiddles[p]), w1i = _mm_set1_ps(twiddles[n1 + p]);
+            const auto w2r = _mm_set1_ps(twiddles[2 * n1 + p]), w2i = _mm_set1_ps(twiddles[3 * n1 + p]);
+            const auto w3r = _mm_set1_ps(twiddles[4 * n1 + p]), w3i = _mm_set1_ps(twiddles[5 * n1 + p]);
+
+            const auto* inR = xr + s * p;
+            const auto* inI = xi + s * p;
+            auto* outR = yr + s * 4 * p;
+            auto* outI = yi + s * 4 * p;
+            const int quarter = s * n1;
+
+            for (int q = 0; q < s; q += 4)
+            {
+                auto ar = _mm_loadu_ps(inR + q), ai = _mm_loadu_ps(inI + q);
+                auto br = _mm_loadu_ps(inR + quarter + q), bi = _mm_loadu_ps(inI + quarter + q);
+                auto cr = _mm_loadu_ps(inR + 2 * quarter + q), ci = _mm_loadu_ps(inI + 2 * quarter + q);
+                auto dr = _mm_loadu_ps(inR + 3 * quarter + q), di = _mm_loadu_ps(inI + 3 * quarter + q);
+
+                radix4SSE2(ar, ai, br, bi, cr, ci, dr, di, w1r, w1i, w2r, w2i, w3r, w3i);
+
+                _mm_storeu_ps(outR + q, ar);
+                _mm_storeu_ps(outI + q, ai);
+                _mm_storeu_ps(outR + s + q, br);
+                _mm_storeu_ps(outI + s + q, bi);
+                _mm_storeu_ps(outR + 2 * s + q, cr);
+                _mm_storeu_ps(outI + 2 * s + q, ci);
+                _mm_storeu_ps(outR + 3 * s + q, dr);
+                _mm_storeu_ps(outI + 3 * s + q, di);
+            }
+        }
+    }
+
+    DSP_TARGET("sse2") void realFFTMagnitudesSSE2(const float* zr, const float* zi, const float* twiddles, float* dest,
+                                                  int m, int startBin, int numBins)
+    {
+        //bin 0 mirrors onto itself
+        int i = 0;
+        if (startBin == 0 && numBins > 0)
+        {
+            realFFTMagnitudesScalar(zr, zi, twiddles, dest, m, 0, 1);
+            i = 1;
+        }
+
+        const auto half = _mm_set1_ps(0.5f);
+
+        for (; i + 4 <= numBins; i += 4)
+        {
+            const int k = startBin + i;
+
+            //Z[m - k - 3 .. m - k] reversed
+            auto mr = _mm_loadu_ps(zr + m - k - 3);
+            auto mi = _mm_loadu_ps(zi + m - k - 3);
+            mr = _mm_shuffle_ps(mr, mr, _MM_SHUFFLE(0, 1, 2, 3));
+            mi = _mm_shuffle_ps(mi, mi, _MM_SHUFFLE(0, 1, 2, 3));
+
+            const auto ar = _mm_loadu_ps(zr + k), ai = _mm_loadu_ps(zi + k);
+            const auto er = _mm_mul_ps(half, _mm_add_ps(ar, mr)), ei = _mm_mul_ps(half, _mm_sub_ps(ai, mi));
+            const auto orr = _mm_mul_ps(half, _mm_add_ps(ai, mi)), oi = _mm_mul_ps(half, _mm_sub_ps(mr, ar));
+            const auto wr = _mm_loadu_ps(twiddles + k), sn = _mm_loadu_ps(twiddles + m + k);
+
+            //w = wr - j sn
+            const auto re = _mm_add_ps(er, _mm_add_ps(_mm_mul_ps(wr, orr), _mm_mul_ps(sn, oi)));
+            const auto im = _mm_sub_ps(_mm_add_ps(ei, _mm_mul_ps(wr, oi)), _mm_mul_ps(sn, orr));
+            _mm_storeu_ps(dest + i, _mm_sqrt_ps(_mm_add_ps(_mm_mul_ps(re, re), _mm_mul_ps(im, im))));
+        }
+
+        realFFTMagnitudesScalar(zr, zi, twiddles, dest + i, m, startBin + i, numBins - i);
+    }
+
+#pragma endregion
+
+#pragma region AVX2
+
+    DSP_TARGET("avx2,fma") inline __m256 log2AVX2(__m256 x)
+    {
+        const auto bits = _mm256_castps_si256(x);
+        const auto exponent = _mm256_cvtepi32_ps(_mm256_sub_epi32(_mm256_srli_epi32(bits, 23), _mm256_set1_epi32(127)));
+        const auto mantissa = _mm256_castsi256_ps(_mm256_or_si256(_mm256_and_si256(bits, _mm256_set1_epi32(0x007FFFFF)),
+                                                                  _mm256_set1_epi32(0x3F800000)));
+        const auto t = _mm256_sub_ps(mantissa, _mm256_set1_ps(1.f));
+
+        auto p = _mm256_set1_ps(log2C5);
+        p = _mm256_fmadd_ps(p, t, _mm256_set1_ps(log2C4));
+        p = _mm256_fmadd_ps(p, t, _mm256_set1_ps(log2C3));
+        p = _mm256_fmadd_ps(p, t, _mm256_set1_ps(log2C2));
+        p = _mm256_fmadd_ps(p, t, _mm256_set1_ps(log2C1));
+        return _mm256_fmadd_ps(p, t, exponent);
+    }
+
+    DSP_TARGET("avx2,fma") void multiplyAVX2(float* data, const float* window, int num)
+    {
+        int i = 0;
+        for (; i + 8 <= num; i += 8)
+            _mm256_storeu_ps(data + i, _mm256_mul_ps(_mm256_loadu_ps(data + i), _mm256_loadu_ps(window + i)));
+
+        multiplySSE2(data + i, window + i, num - i);
+    }
+
+    DSP_TARGET("avx2,fma") inline __m256 decibelsAVX2(__m256 v, __m256 floorV)
+    {
+        const auto finite = _mm256_cmp_ps(_mm256_and_ps(v, _mm256_castsi256_ps(_mm256_set1_epi32(0x7FFFFFFF))),
+                                          _mm256_set1_ps(std::numeric_limits<float>::infinity()), _CMP_LT_OQ);
+        const auto db = _mm256_max_ps(_mm256_mul_ps(log2AVX2(_mm256_max_ps(v, _mm256_set1_ps(smallestGain))),
+                                                    _mm256_set1_ps(decibelsPerOctave)), floorV);
+        return _mm256_blendv_ps(floorV, db, finite);
+    }
+
+    DSP_TARGET("avx2,fma") void magnitudesToDecibelsAVX2(float* data, int num, float scale, float negativeInfinity)
+    {
+        const auto scaleV = _mm256_set1_ps(scale);
+        const auto floorV = _mm256_set1_ps(negativeInfinity);
+
+        int i = 0;
+        for (; i + 8 <= num; i += 8)
+            _mm256_storeu_ps(data + i, decibelsAVX2(_mm256_mul_ps(_mm256_loadu_ps(data + i), scaleV), floorV));
+
+        magnitudesToDecibelsSSE2(data + i, num - i, scale, negativeInfinity);
+    }
+
+    DSP_TARGET("avx2,fma") void averagePowerToDecibelsAVX2(float* data, float* state, int num, float scale, float weight,
+                                                           float negativeInfinity)
+    {
+        const auto scaleV = _mm256_set1_ps(scale);
+        const auto weightV = _mm256_set1_ps(weight);
+        const auto floorV = _mm256_set1_ps(negativeInfinity);
+        const auto infinity = _mm256_set1_ps(std::numeric_limits<float>::infinity());
+        const auto absMask = _mm256_castsi256_ps(_mm256_set1_epi32(0x7FFFFFFF));
+        const auto smallest = _mm256_set1_ps(smallestGain);
+        const auto toDecibels = _mm256_set1_ps(powerDecibelsPerOctave);
+
+        int i = 0;
+        for (; i + 8 <= num; i += 8)
+        {
+            auto v = _mm256_mul_ps(_mm256_loadu_ps(data + i), scaleV);
+            auto finite = _mm256_cmp_ps(_mm256_and_ps(v, absMask), infinity, _CMP_LT_OQ);
+            auto power = _mm256_and_ps(finite, _mm256_mul_ps(v, v));
+
+            auto average = _mm256_loadu_ps(state + i);
+            average = _mm256_fmadd_ps(weightV, _mm256_sub_ps(power, average), average);
+            _mm256_storeu_ps(state + i, average);
+
+            auto db = _mm256_mul_ps(log2AVX2(_mm256_max_ps(average, smallest)), toDecibels);
+            _mm256_storeu_ps(data + i, _mm256_max_ps(db, floorV));
+        }
+
+        averagePowerToDecibelsSSE2(data + i, state + i, num - i, scale, weight, negativeInfinity);
+    }
+
+    DSP_TARGET("avx2,fma") void peakHoldToDecibelsAVX2(float* data, float* state, int num, float scale,
+                                                       float decayInDecibels, float negativeInfinity)
+    {
+        const auto scaleV = _mm256_set1_ps(scale);
+        const auto decay = _mm256_set1_ps(decayInDecibels);
+        const auto floorV = _mm256_set1_ps(negativeInfinity);
+
+        int i = 0;
+        for (; i + 8 <= num; i += 8)
+        {
+            auto db = decibelsAVX2(_mm256_mul_ps(_mm256_loadu_ps(data + i), scaleV), floorV);
+            auto held = _mm256_max_ps(db, _mm256_max_ps(_mm256_sub_ps(_mm256_loadu_ps(state + i), decay), floorV));
+            _mm256_storeu_ps(state + i, held);
+            _mm256_storeu_ps(data + i, held);
+        }
+
+        peakHoldToDecibelsSSE2(data + i, state + i, num - i, scale, decayInDecibels, negativeInfinity);
+    }
+
+    DSP_TARGET("avx2,fma") void biquadCascadeAVX2(float* left, float* right, int numSamples, StereoBiquadCascade& cascade)
+    {
+        for (int n = 0; n < cascade.numActiveStages; ++n)
+        {
+            const auto stage = cascade.activeStages[n];
+            const auto& c = cascade.coefficients[stage];
+            auto* z = cascade.state[stage];
+
+            const auto b0 = _mm_set1_ps(c[0]), b1 = _mm_set1_ps(c[1]), b2 = _mm_set1_ps(c[2]);
+            const auto a1 = _mm_set1_ps(c[3]), a2 = _mm_set1_ps(c[4]);
+            auto z1 = _mm_setr_ps(z[0], z[1], 0.f, 0.f);
+            auto z2 = _mm_setr_ps(z[2], z[3], 0.f, 0.f);
+
+            for (int i = 0; i < numSamples; ++i)
+            {
+                auto x = _mm_unpacklo_ps(_mm_load_ss(left + i), _mm_load_ss(right + i));
+                auto y = _mm_fmadd_ps(b0, x, z1);
+                z1 = _mm_fnmadd_ps(a1, y, _mm_fmadd_ps(b1, x, z2));
+                z2 = _mm_fnmadd_ps(a2, y, _mm_mul_ps(b2, x));
+
+                _mm_store_ss(left + i, y);
+                _mm_store_ss(right + i, _mm_shuffle_ps(y, y, _MM_SHUFFLE(1, 1, 1, 1)));
+            }
+
+            alignas(16) float stored[4];
+            _mm_store_ps(stored, _mm_movelh_ps(z1, z2));
+            std::copy(stored, stored + 4, z);
+        }
+    }
+
+    DSP_TARGET("avx2,fma") inline void radix4AVX2(__m256& ar, __m256& ai, __m256& br, __m256& bi,
+                                                  __m256& cr, __m256& ci, __m256& dr, __m256& di,
+                                                  __m256 w1r, __m256 w1i, __m256 w2r, __m256 w2i, __m256 w3r, __m256 w3i)
+    {
+        const auto apcR = _mm256_add_ps(ar, cr), apcI = _mm256_add_ps(ai, ci);
+        const auto amcR = _mm256_sub_ps(ar, cr), amcI = _mm256_sub_ps(ai, ci);
+        const auto bpdR = _mm256_add_ps(br, dr), bpdI = _mm256_add_ps(bi, di);
+        const auto bmdR = _mm256_sub_ps(br, dr), bmdI = _mm256_sub_ps(bi, di);
+
+        const auto u1r = _mm256_add_ps(amcR, bmdI), u1i = _mm256_sub_ps(amcI, bmdR);
+        const auto u2r = _mm256_sub_ps(apcR, bpdR), u2i = _mm256_sub_ps(apcI, bpdI);
+        const auto u3r = _mm256_sub_ps(amcR, bmdI), u3i = _mm256_add_ps(amcI, bmdR);
+
+        ar = _mm256_add_ps(apcR, bpdR);
+        ai = _mm256_add_ps(apcI, bpdI);
+        br = _mm256_fmsub_ps(w1r, u1r, _mm256_mul_ps(w1i, u1i));
+        bi = _mm256_fmadd_ps(w1r, u1i, _mm256_mul_ps(w1i, u1r));
+        cr = _mm256_fmsub_ps(w2r, u2r, _mm256_mul_ps(w2i, u2i));
+        ci = _mm256_fmadd_ps(w2r, u2i, _mm256_mul_ps(w2i, u2r));
+        dr = _mm256_fmsub_ps(w3r, u3r, _mm256_mul_ps(w3i, u3i));
+        di = _mm256_fmadd_ps(w3r, u3i, _mm256_mul_ps(w3i, u3r));
+    }
+
+    DSP_TARGET("avx2,fma") void fftRadix4PassAVX2(const float* xr, const float* xi, float* yr, float* yi, int n, int s,
+                                                  const float* twiddles)
+    {
+        //the first passes are narrower than a register
+        if (s < 8)
+        {
+            fftRadix4PassSSE2(xr, xi, yr, yi, n, s, twiddles);
+            return;
+        }
+
+        const int n1 = n / 4;
+
+        for (int p = 0; p < n1; ++p)
+        {
+            const auto w1r = _mm256_set1_ps(twiddles[p]), w1i = _mm256_set1_ps(twiddles[n1 + p]);
+            const auto w2r = _mm256_set1_ps(twiddles[2 * n1 + p]), w2i = _mm256_set1_ps(twiddles[3 * n1 + p]);
+            const auto w3r = _mm256_set1_ps(twiddles[4 * n1 + p]), w3i = _mm256_set1_ps(twiddles[5 * n1 + p]);
+
+            const auto* inR = xr + s * p;
+            const auto* inI = xi + s * p;
+            auto* outR = yr + s * 4 * p;
+            auto* outI = yi + s * 4 * p;
+            const int quarter = s * n1;
+
+            for (int q = 0; q < s; q += 8)
+            {
+                auto ar = _mm256_loadu_ps(inR + q), ai = _mm256_loadu_ps(inI + q);
+                auto br = _mm256_loadu_ps(inR + quarter + q), bi = _mm256_loadu_ps(inI + quarter + q);
+                auto cr = _mm256_loadu_ps(inR + 2 * quarter + q), ci = _mm256_loadu_ps(inI + 2 * quarter + q);
+                auto dr = _mm256_loadu_ps(inR + 3 * quarter + q), di = _mm256_loadu_ps(inI + 3 * quarter + q);
+
+                radix4AVX2(ar, ai, br, bi, cr, ci, dr, di, w1r, w1i, w2r, w2i, w3r, w3i);
+
+                _mm256_storeu_ps(outR + q, ar);
+                _mm256_storeu_ps(outI + q, ai);
+                _mm256_storeu_ps(outR + s + q, br);
+                _mm256_storeu_ps(outI + s + q, bi);
+                _mm256_storeu_ps(outR + 2 * s + q, cr);
+                _mm256_storeu_ps(outI + 2 * s + q, ci);
+                _mm256_storeu_ps(outR + 3 * s + q, dr);
+                _mm256_storeu_ps(outI + 3 * s + q, di);
+            }
+        }
+    }
+
+    DSP_TARGET("avx2,fma") void realFFTMagnitudesAVX2(const float* zr, const float* zi, const float* twiddles, float* dest,
+                                                      int m, int startBin, int numBins)
+    {
+        int i = 0;
+        if (startBin == 0 && numBins > 0)
+        {
+            realFFTMagnitudesScalar(zr, zi, twiddles, dest, m, 0, 1);
+            i = 1;
+        }
+
+        const auto half = _mm256_set1_ps(0.5f);
+        const auto reverse = _mm256_setr_epi32(7, 6, 5, 4, 3, 2, 1, 0);
+
+        for (; i + 8 <= numBins; i += 8)
+        {
+            const int k = startBin + i;
+
+            const auto mr = _mm256_permutevar8x32_ps(_mm256_loadu_ps(zr + m - k - 7), reverse);
+            const auto mi = _mm256_permutevar8x32_ps(_mm256_loadu_ps(zi + m - k - 7), reverse);
+
+            const auto ar = _mm256_loadu_ps(zr + k), ai = _mm256_loadu_ps(zi + k);
+            const auto er = _mm256_mul_ps(half, _mm256_add_ps(ar, mr)), ei = _mm256_mul_ps(half, _mm256_sub_ps(ai, mi));
+            const auto orr = _mm256_mul_ps(half, _mm256_add_ps(ai, mi)), oi = _mm256_mul_ps(half, _mm256_sub_ps(mr, ar));
+            const auto wr = _mm256_loadu_ps(twiddles + k), sn = _mm256_loadu_ps(twiddles + m + k);
+
+            const auto re = _mm256_fmadd_ps(sn, oi, _mm256_fmadd_ps(wr, orr, er));
+            const auto im = _mm256_fnmadd_ps(sn, orr, _mm256_fmadd_ps(wr, oi, ei));
+            _mm256_storeu_ps(dest + i, _mm256_sqrt_ps(_mm256_fmadd_ps(re, re, _mm256_mul_ps(im, im))));
+        }
+
+        realFFTMagnitudesSSE2(zr, zi, twiddles, dest + i, m, startBin + i, numBins - i);
+    }
+
+#pragma endregion
+
+#pragma region AVX512
+
+    DSP_TARGET("avx512f") inline __m512 log2AVX512(__m512 x)
+    {
+        const auto bits = _mm512_castps_si512(x);
+        const auto exponent = _mm512_cvtepi32_ps(_mm512_sub_epi32(_mm512_srli_epi32(bits, 23), _mm512_set1_epi32(127)));
+        const auto mantissa = _mm512_castsi512_ps(_mm512_or_si512(_mm512_and_si512(bits, _mm512_set1_epi32(0x007FFFFF)),
+                                                                  _mm512_set1_epi32(0x3F800000)));
+        const auto t = _mm512_sub_ps(mantissa, _mm512_set1_ps(1.f));
+
+        auto p = _mm512_set1_ps(log2C5);
+        p = _mm512_fmadd_ps(p, t, _mm512_set1_ps(log2C4));
+        p = _mm512_fmadd_ps(p, t, _mm512_set1_ps(log2C3));
+        p = _mm512_fmadd_ps(p, t, _mm512_set1_ps(log2C2));
+        p = _mm512_fmadd_ps(p, t, _mm512_set1_ps(log2C1));
+        return _mm512_fmadd_ps(p, t, exponent);
+    }
+
+    DSP_TARGET("avx512f") void multiplyAVX512(float* data, const float* window, int num)
+    {
+        int i = 0;
+        for (; i + 16 <= num; i += 16)
+            _mm512_storeu_ps(data + i, _mm512_mul_ps(_mm512_loadu_ps(data + i), _mm512_loadu_ps(window + i)));
+
+        multiplyAVX2(data + i, window + i, num - i);
+    }
+
+    DSP_TARGET("avx512f") inline __m512 decibelsAVX512(__m512 v, __m512 floorV)
+    {
+        const auto finite = _mm512_cmp_ps_mask(_mm512_abs_ps(v), _mm512_set1_ps(std::numeric_limits<float>::infinity()),
+                                               _CMP_LT_OQ);
+        const auto db = _mm512_max_ps(_mm512_mul_ps(log2AVX512(_mm512_max_ps(v, _mm512_set1_ps(smallestGain))),
+                                                    _mm512_set1_ps(decibelsPerOctave)), floorV);
+        return _mm512_mask_blend_ps(finite, floorV, db);
+    }
+
+    DSP_TARGET("avx512f") void magnitudesToDecibelsAVX512(float* data, int num, float scale, float negativeInfinity)
+    {
+        const auto scaleV = _mm512_set1_ps(scale);
+        const auto floorV = _mm512_set1_ps(negativeInfinity);
+
+        int i = 0;
+        for (; i + 16 <= num; i += 16)
+            _mm512_storeu_ps(data + i, decibelsAVX512(_mm512_mul_ps(_mm512_loadu_ps(data + i), scaleV), floorV));
+
+        magnitudesToDecibelsAVX2(data + i, num - i, scale, negativeInfinity);
+    }
+
+    DSP_TARGET("avx512f") void averagePowerToDecibelsAVX512(float* data, float* state, int num, float scale, float weight,
+                                                            float negativeInfinity)
+    {
+        const auto scaleV = _mm512_set1_ps(scale);
+        const auto weightV = _mm512_set1_ps(weight);
+        const auto floorV = _mm512_set1_ps(negativeInfinity);
+        const auto infinity = _mm512_set1_ps(std::numeric_limits<float>::infinity());
+        const auto smallest = _mm512_set1_ps(smallestGain);
+        const auto toDecibels = _mm512_set1_ps(powerDecibelsPerOctave);
+
+        int i = 0;
+        for (; i + 16 <= num; i += 16)
+        {
+            auto v = _mm512_mul_ps(_mm512_loadu_ps(data + i), scaleV);
+            auto finite = _mm512_cmp_ps_mask(_mm512_abs_ps(v), infinity, _CMP_LT_OQ);
+            auto power = _mm512_maskz_mul_ps(finite, v, v);
+
+            auto average = _mm512_loadu_ps(state + i);
+            average = _mm512_fmadd_ps(weightV, _mm512_sub_ps(power, average), average);
+            _mm512_storeu_ps(state + i, average);
+
+            auto db = _mm512_mul_ps(log2AVX512(_mm512_max_ps(average, smallest)), toDecibels);
+            _mm512_storeu_ps(data + i, _mm512_max_ps(db, floorV));
+        }
+
+        averagePowerToDecibelsAVX2(data + i, state + i, num - i, scale, weight, negativeInfinity);
+    }
+
+    DSP_TARGET("avx512f") void peakHoldToDecibelsAVX512(float* data, float* state, int num, float scale,
+                                                        float decayInDecibels, float negativeInfinity)
+    {
+        const auto scaleV = _mm512_set1_ps(scale);
+        const auto decay = _mm512_set1_ps(decayInDecibels);
+        const auto floorV = _mm512_set1_ps(negativeInfinity);
+
+        int i = 0;
+        for (; i + 16 <= num; i += 16)
+        {
+            auto db = decibelsAVX512(_mm512_mul_ps(_mm512_loadu_ps(data + i), scaleV), floorV);
+            auto held = _mm512_max_ps(db, _mm512_max_ps(_mm512_sub_ps(_mm512_loadu_ps(state + i), decay), floorV));
+            _mm512_storeu_ps(state + i, held);
+            _mm512_storeu_ps(data + i, held);
+        }
+
+        peakHoldToDecibelsAVX2(data + i, state + i, num - i, scale, decayInDecibels, negativeInfinity);
+    }
+
+#pragma endregion
+
+#endif
+
+#if JUCE_INTEL
+    const DspKernels kernelTable[] =
+    {
+        {SimdLevel::Scalar, "Scalar", multiplyScalar, magnitudesToDecibelsScalar,
+         averagePowerToDecibelsScalar, peakHoldToDecibelsScalar, biquadCascadeScalar,
+         fftRadix4PassScalar, realFFTMagnitudesScalar},
+        {SimdLevel::SSE2, "SSE2", multiplySSE2, magnitudesToDecibelsSSE2,
+         averagePowerToDecibelsSSE2, peakHoldToDecibelsSSE2, biquadCascadeSSE2,
+         fftRadix4PassSSE2, realFFTMagnitudesSSE2},
+        {SimdLevel::AVX2, "AVX2", multiplyAVX2, magnitudesToDecibelsAVX2,
+         averagePowerToDecibelsAVX2, peakHoldToDecibelsAVX2, biquadCascadeAVX2,
+         fftRadix4PassAVX2, realFFTMagnitudesAVX2},
+        //two channels can't fill more than a 128 bit register, the cascade stays on the AVX2 variant;
+        //the FFT passes are limited by memory traffic rather than width and stay there too
+        {SimdLevel::AVX512, "AVX-512", multiplyAVX512, magnitudesToDecibelsAVX512,
+         averagePowerToDecibelsAVX512, peakHoldToDecibelsAVX512, biquadCascadeAVX2,
+         fftRadix4PassAVX2, realFFTMagnitudesAVX2},
+    };
+#else
+    const DspKernels kernelTable[] =
+    {
+        {SimdLevel::Scalar, "Scalar", multiplyScalar, magnitudesToDecibelsScalar,
+         averagePowerToDecibelsScalar, peakHoldToDecibelsScalar, biquadCascadeScalar,
+         fftRadix4PassScalar, realFFTMagnitudesScalar},
+    };
+#endif
+}
+
+bool isSimdLevelSupported(SimdLevel level)
+{
+   #if JUCE_INTEL
+    using juce::SystemStats;
+
+    switch (level)
+    {
+    case SimdLevel::Scalar: return true;
+    case SimdLevel::SSE2: return SystemStats::hasSSE2();
+    case SimdLevel::AVX2: return SystemStats::hasAVX2() && SystemStats::hasFMA3();
+    case SimdLevel::AVX512: return SystemStats::hasAVX512F() && SystemStats::hasAVX2() && SystemStats::hasFMA3();
+    }
+
+    return false;
+   #else
+    return level == SimdLevel::Scalar;
+   #endif
+}
+
+juce::String getSimdLevelName(SimdLevel level)
+{
+    for (const auto& kernels : kernelTable)
+        if (kernels.level == level)
+            return kernels.name;
+
+    return "Unavailable";
+}
+
+const DspKernels& getDspKernels(SimdLevel level)
+{
+    jassert(isSimdLevelSupported(level));
+
+    for (const auto& kernels : kernelTable)
+        if (kernels.level == level)
+            return kernels;
+
+    return kernelTable[0];
+}
+
+const DspKernels& getDspKernels()
+{
+    static const DspKernels& selected = []() -> const DspKernels&
+    {
+        const auto* best = &kernelTable[0];
+
+        for (const auto& kernels : kernelTable)
+            if (isSimdLevelSupported(kernels.level))
+                best = &kernels;
+
+        juce::Logger::writeToLog("SampleEQ: DSP kernels dispatched to " + juce::String(best->name)
+                                 + " (" + juce::SystemStats::getCpuModel() + ")");
+        return *best;
+    }();
+
+    return selected;
+}
@@ -0,0 +1,84 @@
+/*
+  ==============================================================================
+
+    DspKernels.h
+    Created: 19 Oct 2026 4:40:13pm
+    Author:  tyzTang
+
+  ==============================================================================
+*/
+
+#pragma once
+#include <JuceHeader.h>
+
+enum class SimdLevel
+{
+    Scalar,
+    SSE2,
+    AVX2,
+    AVX512,
+};
+
+using BiquadCoefficients = std::array<float, 5>;
+
+/*
+ LowCut (4) + Peak (1) + HighCut (4) biquads for both channels.
+ Every slot keeps its own state, so bypassing a stage doesn't disturb the others.
+ */
+struct StereoBiquadCascade
+{
+    static constexpr int maxStages = 9;
+
+    std::array<BiquadCoefficients, maxStages> coefficients{};
+    std::array<int, maxStages> activeStages{};
+    int numActiveStages = 0;
+
+    //z1 left, z1 right, z2 left, z2 right
+    alignas(16) float state[maxStages][4]{};
+
+    void reset() { std::fill(&state[0][0], &state[0][0] + maxStages * 4, 0.f); }
+};
+
+/*
+ Hot loops of the plugin, compiled once per ISA and picked at runtime.
+ The plugin itself is built for the baseline ISA, so the wider variants use
+ per-function target attributes and are only called when the CPU has them.
+ */
+struct DspKernels
+{
+    SimdLevel level;
+    const char* name;
+
+    //analyzer windowing, data[i] *= window[i]
+    void (*multiply)(float* data, const float* window, int num);
+
+    //analyzer post-processing, data[i] = max(gainToDecibels(data[i] * scale), negativeInfinity), non-finite -> negativeInfinity
+    void (*magnitudesToDecibels)(float* data, int num, float scale, float negativeInfinity);
+
+    //exponential / infinite averaging in the power domain, in the same pass as the dB conversion:
+    //state[i] += weight * ((data[i] * scale)^2 - state[i]), data[i] = max(powerToDecibels(state[i]), negativeInfinity)
+    //non-finite magnitudes count as silence
+    void (*averagePowerToDecibels)(float* data, float* state, int num, float scale, float weight, float negativeInfinity);
+
+    //peak hold with decay: state[i] = max(dB(data[i] * scale), state[i] - decayInDecibels, negativeInfinity), data[i] = state[i]
+    void (*peakHoldToDecibels)(float* data, float* state, int num, float scale, float decayInDecibels, float negativeInfinity);
+
+    //transposed direct form II, in place
+    void (*biquadCascade)(float* left, float* right, int numSamples, StereoBiquadCascade& cascade);
+
+    //one radix-4 Stockham pass of a split complex forward FFT, see BuiltInFFTEngine
+    //length n, stride s; twiddles holds w^p, w^2p, w^3p of w = exp(-2 pi j / n) as re[n/4], im[n/4] each
+    void (*fftRadix4Pass)(const float* xr, const float* xi, float* yr, float* yi, int n, int s, const float* twiddles);
+
+    //real FFT post pass: Z = FFT of the m complex points z[k] = x[2k] + j x[2k+1], dest[i] = |X[startBin + i]|
+    //twiddles holds cos(pi k / m), sin(pi k / m) for k < m
+    void (*realFFTMagnitudes)(const float* zr, const float* zi, const float* twiddles, float* dest, int m,
+                              int startBin, int numBins);
+};
+
+//best variant the CPU supports, chosen (and reported to the log) on first use
+const DspKernels& getDspKernels();
+
+const DspKernels& getDspKernels(SimdLevel level);
+bool isSimdLevelSupported(SimdLevel level);
+juce::String getSimdLevelName(SimdLevel level);
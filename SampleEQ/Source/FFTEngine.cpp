@@ -0,0 +1,234 @@
+/*
+  ==============================================================================
+
+    FFTEngine.cpp
+    Created: 19 Oct 2026 10:14:32pm
+    Author:  tyzTang
+
+  ==============================================================================
+*/
+
+#include "FFTEngine.h"
+#include "SingleChannelSampleFifo.h"
+
+FFTBackend getDefaultFFTBackend()
+{
+   #if JUCE_MAC || JUCE_IOS || JUCE_IPP_AVAILABLE || JUCE_DSP_USE_INTEL_MKL \
+       || JUCE_DSP_USE_SHARED_FFTW || JUCE_DSP_USE_STATIC_FFTW
+    return FFTBackend_Juce;
+   #else
+    //a few ms once, on the first analyzer engine that is built
+    static const bool builtInMatches = []
+    {
+        for (int order = order512; order <= order16384; ++order)
+            if (getFFTDeviation(FFTBackend_BuiltIn, order) > maxFFTDeviation)
+                return false;
+
+        return true;
+    }();
+
+    jassert(builtInMatches);
+    return builtInMatches ? FFTBackend_BuiltIn : FFTBackend_Juce;
+   #endif
+}
+
+juce::String getFFTBackendName(FFTBackend backend)
+{
+    switch (backend)
+    {
+    case FFTBackend_Juce: return "juce::dsp::FFT";
+    case FFTBackend_BuiltIn: return "built-in radix-4";
+    }
+
+    return "Unknown";
+}
+
+std::unique_ptr<FFTEngine> createFFTEngine(FFTBackend backend, int order)
+{
+    if (backend == FFTBackend_BuiltIn)
+        return std::make_unique<BuiltInFFTEngine>(order);
+
+    return std::make_unique<JuceFFTEngine>(order);
+}
+
+float getFFTDeviation(FFTBackend backend, int order)
+{
+    auto reference = createFFTEngine(FFTBackend_Juce, order);
+    auto engine = createFFTEngine(backend, order);
+
+    const auto fftSize = 1 << order;
+    const auto numBins = fftSize / 2;
+
+    std::vector<float> window((size_t)fftSize, 1.f), channel0((size_t)fftSize), channel1((size_t)fftSize);
+    std::vector<float> expected((size_t)numBins), actual((size_t)numBins);
+    juce::Random random(order);
+    float maxDeviation = 0.f;
+
+    for (auto sine : {false, true})
+    {
+        //sines between bins, so every bin has leakage to compare
+        for (int i = 0; i < fftSize; ++i)
+        {
+            channel0[(size_t)i] = sine ? std::sin(juce::MathConstants<float>::twoPi * 0.1234567f * (float)i)
+                                       : random.nextFloat() * 2.f - 1.f;
+            channel1[(size_t)i] = sine ? 0.5f * std::cos(juce::MathConstants<float>::twoPi * 0.0371937f * (float)i)
+                                       : random.nextFloat() * 2.f - 1.f;
+        }
+
+        reference->transform(channel0.data(), channel1.data(), window.data());
+        engine->transform(channel0.data(), channel1.data(), window.data());
+
+        for (int channel = 0; channel < 2; ++channel)
+        {
+            reference->getMagnitudes(channel, expected.data(), 0, numBins);
+            engine->getMagnitudes(channel, actual.data(), 0, numBins);
+
+            const auto peak = juce::jmax(*std::max_element(expected.begin(), expected.end()), 1.0e-20f);
+            for (int k = 0; k < numBins; ++k)
+                maxDeviation = juce::jmax(maxDeviation, std::abs(actual[(size_t)k] - expected[(size_t)k]) / peak);
+        }
+    }
+
+    return maxDeviation;
+}
+
+//==============================================================================
+JuceFFTEngine::JuceFFTEngine(int order) :
+    FFTEngine(order),
+    fft(order),
+    timeData((size_t)getSize()),
+    frequencyData((size_t)getSize())
+{
+}
+
+void JuceFFTEngine::transform(const float* channel0, const float* channel1, const float* window)
+{
+    const auto fftSize = getSize();
+
+    for (int i = 0; i < fftSize; ++i)
+        timeData[(size_t)i] = {channel0[i] * window[i], channel1 != nullptr ? channel1[i] * window[i] : 0.f};
+
+    fft.perform(timeData.data(), frequencyData.data(), false);
+}
+
+void JuceFFTEngine::getMagnitudes(int channel, float* dest, int startBin, int numBins)
+{
+    const auto mask = getSize() - 1;
+
+    for (int i = 0; i < numBins; ++i)
+    {
+        const auto k = startBin + i;
+        const auto z = frequencyData[(size_t)k];
+        const auto mirrored = std::conj(frequencyData[(size_t)((getSize() - k) & mask)]);
+
+        dest[i] = 0.5f * std::abs(channel == 0 ? z + mirrored : z - mirrored);
+    }
+}
+
+size_t JuceFFTEngine::getMemoryUsage() const
+{
+    return (timeData.capacity() + frequencyData.capacity()) * sizeof(juce::dsp::Complex<float>);
+}
+
+//==============================================================================
+BuiltInFFTEngine::BuiltInFFTEngine(int order) :
+    FFTEngine(order),
+    halfSize(getSize() / 2)
+{
+    jassert(order >= 3);
+
+    //w^p, w^2p, w^3p of every radix-4 pass, each as re[n/4] then im[n/4]
+    for (int n = halfSize; n >= 4; n /= 4)
+    {
+        for (int power = 1; power <= 3; ++power)
+        {
+            for (int p = 0; p < n / 4; ++p)
+                passTwiddles.push_back((float)std::cos(-juce::MathConstants<double>::twoPi * power * p / n));
+            for (int p = 0; p < n / 4; ++p)
+                passTwiddles.push_back((float)std::sin(-juce::MathConstants<double>::twoPi * power * p / n));
+        }
+    }
+
+    realTwiddles.resize((size_t)halfSize * 2);
+    for (int k = 0; k < halfSize; ++k)
+    {
+        realTwiddles[(size_t)k] = (float)std::cos(juce::MathConstants<double>::pi * k / halfSize);
+        realTwiddles[(size_t)(halfSize + k)] = (float)std::sin(juce::MathConstants<double>::pi * k / halfSize);
+    }
+
+    for (auto& channel : channels)
+        for (auto* buffer : {&channel.re, &channel.im, &channel.workRe, &channel.workIm})
+            buffer->assign((size_t)halfSize, 0.f);
+}
+
+void BuiltInFFTEngine::transform(const float* channel0, const float* channel1, const float* window)
+{
+    transformChannel(channels[0], channel0, window);
+
+    if (channel1 != nullptr)
+        transformChannel(channels[1], channel1, window);
+}
+
+void BuiltInFFTEngine::transformChannel(ChannelData& channel, const float* input, const float* window)
+{
+    auto* xr = channel.re.data();
+    auto* xi = channel.im.data();
+    auto* yr = channel.workRe.data();
+    auto* yi = channel.workIm.data();
+
+    //even samples to the real part, odd ones to the imaginary part, windowed on the way
+    for (int k = 0; k < halfSize; ++k)
+    {
+        xr[k] = input[2 * k] * window[2 * k];
+        xi[k] = input[2 * k + 1] * window[2 * k + 1];
+    }
+
+    const auto* twiddles = passTwiddles.data();
+    int n = halfSize, stride = 1;
+
+    for (; n >= 4; n /= 4, stride *= 4)
+    {
+        kernels.fftRadix4Pass(xr, xi, yr, yi, n, stride, twiddles);
+        twiddles += 6 * (n / 4);
+
+        std::swap(xr, yr);
+        std::swap(xi, yi);
+    }
+
+    //odd orders end on a radix-2 pass with unit twiddles
+    if (n == 2)
+    {
+        for (int q = 0; q < stride; ++q)
+        {
+            const auto ar = xr[q], ai = xi[q], br = xr[q + stride], bi = xi[q + stride];
+            yr[q] = ar + br;
+            yi[q] = ai + bi;
+            yr[q + stride] = ar - br;
+            yi[q + stride] = ai - bi;
+        }
+
+        std::swap(xr, yr);
+        std::swap(xi, yi);
+    }
+
+    channel.spectrumRe = xr;
+    channel.spectrumIm = xi;
+}
+
+void BuiltInFFTEngine::getMagnitudes(int channel, float* dest, int startBin, int numBins)
+{
+    const auto& data = channels[channel];
+    jassert(data.spectrumRe != nullptr);
+
+    kernels.realFFTMagnitudes(data.spectrumRe, data.spectrumIm, realTwiddles.data(), dest, halfSize, startBin, numBins);
+}
+
+size_t BuiltInFFTEngine::getMemoryUsage() const
+{
+    size_t floats = passTwiddles.capacity() + realTwiddles.capacity();
+
+    for (const auto& channel : channels)
+        floats += channel.re.capacity() + channel.im.capacity() + channel.workRe.capacity() + channel.workIm.capacity();
+
+    return floats * sizeof(float);
+}
@@ -0,0 +1,125 @@
+/*
+  ==============================================================================
+
+    FFTEngine.h
+    Created: 19 Oct 2026 10:14:32pm
+    Author:  tyzTang
+
+  ==============================================================================
+*/
+
+#pragma once
+#include <JuceHeader.h>
+
+#include "DspKernels.h"
+
+enum FFTBackend
+{
+    FFTBackend_Juce, //juce::dsp::FFT, IPP / vDSP / FFTW when the build has them, its generic fallback otherwise
+    FFTBackend_BuiltIn, //BuiltInFFTEngine
+};
+
+/*
+ The built-in engine unless juce::dsp::FFT was built with a native library.
+ The built-in engine is checked against juce::dsp::FFT at every FFTOrder the
+ first time this is called and is only chosen if it stays within
+ maxFFTDeviation.
+ */
+FFTBackend getDefaultFFTBackend();
+juce::String getFFTBackendName(FFTBackend backend);
+
+//largest |backend - juce::dsp::FFT| bin magnitude over a random and a sine frame, relative to the largest magnitude
+float getFFTDeviation(FFTBackend backend, int order);
+constexpr float maxFFTDeviation = 1.0e-4f;
+
+/*
+ The transform behind the analyzer: one or two windowed real frames in,
+ bin magnitudes out.
+
+ transform() keeps the spectra inside, getMagnitudes() hands them out a run
+ of bins at a time, so the caller's normalisation and dB conversion work on
+ magnitudes that are still in L1 instead of making another pass over the frame.
+ */
+class FFTEngine
+{
+public:
+    virtual ~FFTEngine() = default;
+
+    int getOrder() const { return order; }
+    int getSize() const { return 1 << order; }
+
+    //getSize() samples per channel, 'channel1' may be nullptr; the window is applied while loading
+    virtual void transform(const float* channel0, const float* channel1, const float* window) = 0;
+
+    //|X[k]| of one channel for k in [startBin, startBin + numBins), all below getSize() / 2
+    virtual void getMagnitudes(int channel, float* dest, int startBin, int numBins) = 0;
+
+    virtual size_t getMemoryUsage() const = 0;
+
+    //bins per getMagnitudes() call when a whole frame is post-processed
+    static constexpr int binsPerRun = 512;
+
+protected:
+    explicit FFTEngine(int fftOrder) : order(fftOrder) {}
+
+    const int order;
+};
+
+std::unique_ptr<FFTEngine> createFFTEngine(FFTBackend backend, int order);
+
+/*
+ Both channels through one complex juce::dsp::FFT: channel 0 goes in the real
+ part, channel 1 in the imaginary part, and the two spectra are separated with
+     X0[k] = (Z[k] + conj(Z[N-k])) / 2,   X1[k] = (Z[k] - conj(Z[N-k])) / 2j
+ */
+class JuceFFTEngine : public FFTEngine
+{
+public:
+    explicit JuceFFTEngine(int order);
+
+    void transform(const float* channel0, const float* channel1, const float* window) override;
+    void getMagnitudes(int channel, float* dest, int startBin, int numBins) override;
+    size_t getMemoryUsage() const override;
+
+private:
+    juce::dsp::FFT fft;
+    std::vector<juce::dsp::Complex<float>> timeData, frequencyData;
+};
+
+/*
+ Real FFT of N points as a complex FFT of N/2 points: even samples in the
+ real part, odd samples in the imaginary part, split apart again in the
+ magnitude pass (DspKernels::realFFTMagnitudes).
+
+ The complex FFT is a radix-4 Stockham transform over split re / im arrays,
+ with one radix-2 pass at the end for odd orders. Every pass streams through
+ contiguous memory and the output comes out in natural order, there is no
+ bit reversal. The passes run on the DspKernels variant the CPU supports.
+ */
+class BuiltInFFTEngine : public FFTEngine
+{
+public:
+    explicit BuiltInFFTEngine(int order);
+
+    void transform(const float* channel0, const float* channel1, const float* window) override;
+    void getMagnitudes(int channel, float* dest, int startBin, int numBins) override;
+    size_t getMemoryUsage() const override;
+
+private:
+    //re / im of the half size complex sequence and its ping-pong partner
+    struct ChannelData
+    {
+        std::vector<float> re, im, workRe, workIm;
+        const float* spectrumRe = nullptr;
+        const float* spectrumIm = nullptr;
+    };
+
+    void transformChannel(ChannelData& channel, const float* input, const float* window);
+
+    const int halfSize;
+    const DspKernels& kernels = getDspKernels();
+
+    std::vector<float> passTwiddles; //per radix-4 pass, see DspKernels::fftRadix4Pass
+    std::vector<float> realTwiddles; //cos, sin of pi k / halfSize
+    ChannelData channels[2];
+};
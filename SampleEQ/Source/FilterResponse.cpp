@@ -0,0 +1,73 @@
+/*
+  ==============================================================================
+
+    FilterResponse.cpp
+    Created: 19 Oct 2026 11:20:05am
+    Author:  tyzTang
+
+  ==============================================================================
+*/
+
+#include "FilterResponse.h"
+
+void FilterResponse::setFrequencies(const std::vector<double>& newFrequencies, double sampleRate)
+{
+    frequencies = newFrequencies;
+    phi.resize(frequencies.size());
+
+    for (size_t i = 0; i < frequencies.size(); ++i)
+    {
+        auto s = std::sin(juce::MathConstants<double>::pi * frequencies[i] / sampleRate);
+        phi[i] = s * s;
+    }
+}
+
+void FilterResponse::multiplyMagnitudeSquared(const juce::dsp::IIR::Coefficients<float>& coefficients,
+                                              double* magnitudesSquared) const
+{
+    const auto* c = coefficients.getRawCoefficients();
+    const auto order = coefficients.getFilterOrder();
+
+    //normalised layout: b0 b1 [b2] a1 [a2], a0 == 1
+    double b0 = c[0], b1 = c[1], b2 = 0.0, a1, a2 = 0.0;
+    if (order == 2)
+    {
+        b2 = c[2];
+        a1 = c[3];
+        a2 = c[4];
+    }
+    else
+    {
+        jassert(order == 1);
+        a1 = c[2];
+    }
+
+    // |B|^2 = (b0 + b1 + b2)^2 - 4 (b0 b1 + 4 b0 b2 + b1 b2) phi + 16 b0 b2 phi^2
+    const auto bSum = (b0 + b1 + b2) * (b0 + b1 + b2);
+    const auto bLin = -4.0 * (b0 * b1 + 4.0 * b0 * b2 + b1 * b2);
+    const auto bQuad = 16.0 * b0 * b2;
+
+    const auto aSum = (1.0 + a1 + a2) * (1.0 + a1 + a2);
+    const auto aLin = -4.0 * (a1 + 4.0 * a2 + a1 * a2);
+    const auto aQuad = 16.0 * a2;
+
+    const auto num = (int)phi.size();
+    const auto* p = phi.data();
+
+    for (int i = 0; i < num; ++i)
+    {
+        auto numerator = bSum + p[i] * (bLin + p[i] * bQuad);
+        auto denominator = aSum + p[i] * (aLin + p[i] * aQuad);
+        magnitudesSquared[i] *= numerator / denominator;
+    }
+}
+
+std::vector<double> FilterResponse::makeLogFrequencies(int numPoints, double minFreq, double maxFreq)
+{
+    std::vector<double> result((size_t)numPoints);
+
+    for (int i = 0; i < numPoints; ++i)
+        result[(size_t)i] = juce::mapToLog10((double)i / (double)juce::jmax(1, numPoints - 1), minFreq, maxFreq);
+
+    return result;
+}
@@ -0,0 +1,37 @@
+/*
+  ==============================================================================
+
+    FilterResponse.h
+    Created: 19 Oct 2026 11:20:05am
+    Author:  tyzTang
+
+  ==============================================================================
+*/
+
+#pragma once
+#include <JuceHeader.h>
+
+/*
+ Evaluates |H|^2 of IIR sections on a fixed set of frequencies.
+
+ phi = sin^2(w / 2) is cached per frequency, so each section costs a few
+ multiply-adds per point in a branch-free loop the compiler can vectorise,
+ instead of the complex exponentials of getMagnitudeForFrequency.
+ The phi form also stays accurate for low cut-offs close to DC.
+ */
+struct FilterResponse
+{
+    void setFrequencies(const std::vector<double>& newFrequencies, double sampleRate);
+
+    int getNumFrequencies() const { return (int)frequencies.size(); }
+    const std::vector<double>& getFrequencies() const { return frequencies; }
+
+    //magnitudesSquared[i] *= |H(f_i)|^2
+    void multiplyMagnitudeSquared(const juce::dsp::IIR::Coefficients<float>& coefficients,
+                                  double* magnitudesSquared) const;
+
+    static std::vector<double> makeLogFrequencies(int numPoints, double minFreq = 20.0, double maxFreq = 20000.0);
+
+private:
+    std::vector<double> frequencies, phi;
+};
@@ -0,0 +1,403 @@
+/*
+  ==============================================================================
+
+    MatchEQ.cpp
+    Created: 19 Oct 2026 1:35:52pm
+    Author:  tyzTang
+
+  ==============================================================================
+*/
+
+#include "MatchEQ.h"
+
+#include "FilterResponse.h"
+
+namespace
+{
+    constexpr int numDimensions = 5;
+    using Vertex = std::array<double, numDimensions>;
+
+    //x = { log2 lowCutFreq, log2 peakFreq, peakGain, log2 peakQuality, log2 highCutFreq }
+    ChainSettings decode(const Vertex& x, ChainSettings settings, double maxFrequency)
+    {
+        const auto maxFreq = (float)maxFrequency;
+
+        settings.lowCutFreq = juce::jlimit(20.f, maxFreq, (float)std::exp2(x[0]));
+        settings.peakFreq = juce::jlimit(20.f, maxFreq, (float)std::exp2(x[1]));
+        settings.peakGainInDecibels = juce::jlimit(-24.f, 24.f, (float)x[2]);
+        settings.peakQuality = juce::jlimit(0.1f, 10.f, (float)std::exp2(x[3]));
+        settings.highCutFreq = juce::jlimit(20.f, maxFreq, (float)std::exp2(x[4]));
+        return settings;
+    }
+
+    //mean squared error in dB between the candidate response and the wanted difference
+    double evaluate(const ChainSettings& settings, double sampleRate, const FilterResponse& response,
+                    const std::vector<double>& wanted, std::vector<double>& magnitudes)
+    {
+        std::fill(magnitudes.begin(), magnitudes.end(), 1.0);
+
+        if (!settings.lowCutBypass)
+            for (auto* c : makeLowCutFilters(settings, sampleRate))
+                response.multiplyMagnitudeSquared(*c, magnitudes.data());
+
+        if (!settings.peakBypass)
+            response.multiplyMagnitudeSquared(*makePeakFilter(settings, sampleRate), magnitudes.data());
+
+        if (!settings.highCutBypass)
+            for (auto* c : makeHighCutFilters(settings, sampleRate))
+                response.multiplyMagnitudeSquared(*c, magnitudes.data());
+
+        double error = 0.0;
+        for (size_t i = 0; i < wanted.size(); ++i)
+        {
+            auto d = 10.0 * std::log10(juce::jmax(1.0e-12, magnitudes[i])) - wanted[i];
+            error += d * d;
+        }
+
+        return error / (double)wanted.size();
+    }
+
+    Vertex nelderMead(const std::function<double(const Vertex&)>& cost, Vertex start, const Vertex& steps,
+                      double& bestCost, const std::function<bool()>& shouldStop, int maxIterations = 400)
+    {
+        std::array<Vertex, numDimensions + 1> simplex;
+        std::array<double, numDimensions + 1> costs;
+
+        for (int i = 0; i <= numDimensions; ++i)
+        {
+            simplex[i] = start;
+            if (i > 0)
+                simplex[i][i - 1] += steps[i - 1];
+            costs[i] = cost(simplex[i]);
+        }
+
+        std::array<int, numDimensions + 1> order;
+
+        for (int iteration = 0; iteration < maxIterations; ++iteration)
+        {
+            std::iota(order.begin(), order.end(), 0);
+            std::sort(order.begin(), order.end(), [&costs](int a, int b) { return costs[a] < costs[b]; });
+
+            const auto best = order.front(), worst = order.back(), secondWorst = order[numDimensions - 1];
+
+            if (costs[worst] - costs[best] < 1.0e-6 || shouldStop())
+                break;
+
+            Vertex centroid{};
+            for (int i = 0; i < numDimensions; ++i)
+                for (int d = 0; d < numDimensions; ++d)
+                    centroid[d] += simplex[order[i]][d] / numDimensions;
+
+            auto along = [&](double t)
+            {
+                Vertex v;
+                for (int d = 0; d < numDimensions; ++d)
+                    v[d] = centroid[d] + t * (simplex[worst][d] - centroid[d]);
+                return v;
+            };
+
+            auto reflected = along(-1.0);
+            auto reflectedCost = cost(reflected);
+
+            if (reflectedCost < costs[best])
+            {
+                auto expanded = along(-2.0);
+                auto expandedCost = cost(expanded);
+                simplex[worst] = expandedCost < reflectedCost ? expanded : reflected;
+                costs[worst] = juce::jmin(expandedCost, reflectedCost);
+            }
+            else if (reflectedCost < costs[secondWorst])
+            {
+                simplex[worst] = reflected;
+                costs[worst] = reflectedCost;
+            }
+            else
+            {
+                auto contracted = along(0.5);
+                auto contractedCost = cost(contracted);
+
+                if (contractedCost < costs[worst])
+                {
+                    simplex[worst] = contracted;
+                    costs[worst] = contractedCost;
+                }
+                else
+                {
+                    //shrink towards the best vertex
+                    for (int i = 0; i <= numDimensions; ++i)
+                    {
+                        if (i == best)
+                            continue;
+
+                        for (int d = 0; d < numDimensions; ++d)
+                            simplex[i][d] = simplex[best][d] + 0.5 * (simplex[i][d] - simplex[best][d]);
+                        costs[i] = cost(simplex[i]);
+                    }
+                }
+            }
+        }
+
+        auto best = std::min_element(costs.begin(), costs.end()) - costs.begin();
+        bestCost = costs[best];
+        return simplex[best];
+    }
+}
+
+MatchEQ::MatchEQ() : pool(juce::jmax(1, juce::SystemStats::getNumCpus()))
+{
+    formatManager.registerBasicFormats();
+}
+
+MatchEQResult MatchEQ::match(const juce::File& reference, const juce::File& target, double sampleRate,
+                             std::function<bool()> newShouldExit)
+{
+    shouldExit = std::move(newShouldExit);
+    MatchEQResult result;
+
+    Spectrum referenceSpectrum, targetSpectrum;
+    if (!analyseFile(reference, referenceSpectrum, result.errorMessage)
+        || !analyseFile(target, targetSpectrum, result.errorMessage))
+        return result;
+
+    if (sampleRate <= 0.0)
+        sampleRate = referenceSpectrum.sampleRate;
+
+    //a low rate file or host has nothing up to 20 kHz, and no filter may be designed at or above Nyquist
+    const auto lowestSampleRate = juce::jmin(sampleRate, referenceSpectrum.sampleRate, targetSpectrum.sampleRate);
+    const auto maxFrequency = juce::jmin(20000.0, 0.45 * lowestSampleRate);
+
+    const auto frequencies = FilterResponse::makeLogFrequencies(numGridPoints, 20.0, maxFrequency);
+    const auto referencePower = reduceToGrid(referenceSpectrum, frequencies);
+    const auto targetPower = reduceToGrid(targetSpectrum, frequencies);
+
+    std::vector<double> difference(frequencies.size());
+    for (size_t i = 0; i < difference.size(); ++i)
+        difference[i] = 10.0 * std::log10(juce::jmax(1.0e-20, referencePower[i])
+                                          / juce::jmax(1.0e-20, targetPower[i]));
+
+    //the bands have no broadband gain, so only the shape is matched
+    auto sorted = difference;
+    std::nth_element(sorted.begin(), sorted.begin() + sorted.size() / 2, sorted.end());
+    const auto median = sorted[sorted.size() / 2];
+    for (auto& d : difference)
+        d -= median;
+
+    return fit(difference, sampleRate, maxFrequency);
+}
+
+bool MatchEQ::analyseFile(const juce::File& file, Spectrum& spectrum, juce::String& errorMessage)
+{
+    std::unique_ptr<juce::AudioFormatReader> reader(formatManager.createReaderFor(file));
+    if (reader == nullptr)
+    {
+        errorMessage = "Can't read " + file.getFileName();
+        return false;
+    }
+
+    const auto fftSize = 1 << fftOrder;
+    const auto hopSize = fftSize / 2;
+    const auto numBins = fftSize / 2;
+
+    if (reader->lengthInSamples < fftSize)
+    {
+        errorMessage = file.getFileName() + " is too short";
+        return false;
+    }
+
+    const auto totalFrames = (int)(1 + (reader->lengthInSamples - fftSize) / hopSize);
+    const auto numChunks = (totalFrames + framesPerChunk - 1) / framesPerChunk;
+    const auto numChannels = (int)juce::jmin(2u, reader->numChannels);
+
+    spectrum.sampleRate = reader->sampleRate;
+    spectrum.numFrames = totalFrames;
+    reader.reset();
+
+    std::vector<std::vector<double>> chunkPower((size_t)numChunks);
+
+    runInParallel(numChunks, [&](int chunk)
+    {
+        if (isCancelled())
+            return;
+
+        //readers aren't thread safe, every chunk opens its own
+        std::unique_ptr<juce::AudioFormatReader> chunkReader(formatManager.createReaderFor(file));
+        if (chunkReader == nullptr)
+            return;
+
+        const auto firstFrame = chunk * framesPerChunk;
+        const auto lastFrame = juce::jmin(totalFrames, firstFrame + framesPerChunk);
+        const auto startSample = (juce::int64)firstFrame * hopSize;
+        const auto numSamples = (lastFrame - 1 - firstFrame) * hopSize + fftSize;
+
+        juce::AudioBuffer<float> buffer(numChannels, numSamples);
+        chunkReader->read(&buffer, 0, numSamples, startSample, true, true);
+
+        for (int ch = 1; ch < numChannels; ++ch)
+            buffer.addFrom(0, 0, buffer, ch, 0, numSamples);
+        buffer.applyGain(0, 0, numSamples, 1.f / (float)numChannels);
+
+        juce::dsp::FFT fft(fftOrder);
+        juce::dsp::WindowingFunction<float> window((size_t)fftSize,
+                                                   juce::dsp::WindowingFunction<float>::blackmanHarris);
+        std::vector<float> fftData((size_t)fftSize * 2);
+
+        auto& power = chunkPower[(size_t)chunk];
+        power.assign((size_t)numBins, 0.0);
+
+        for (int frame = firstFrame; frame < lastFrame; ++frame)
+        {
+            auto* readIndex = buffer.getReadPointer(0, (frame - firstFrame) * hopSize);
+            std::copy(readIndex, readIndex + fftSize, fftData.begin());
+            std::fill(fftData.begin() + fftSize, fftData.end(), 0.f);
+
+            window.multiplyWithWindowingTable(fftData.data(), (size_t)fftSize);
+            fft.performFrequencyOnlyForwardTransform(fftData.data());
+
+            for (int bin = 0; bin < numBins; ++bin)
+                power[(size_t)bin] += (double)fftData[(size_t)bin] * (double)fftData[(size_t)bin];
+        }
+    });
+
+    if (isCancelled())
+    {
+        errorMessage = "Cancelled";
+        return false;
+    }
+
+    spectrum.power.assign((size_t)numBins, 0.0);
+    for (const auto& power : chunkPower)
+    {
+        if (power.size() != (size_t)numBins)
+        {
+            errorMessage = "Can't read " + file.getFileName();
+            return false;
+        }
+
+        for (int bin = 0; bin < numBins; ++bin)
+            spectrum.power[(size_t)bin] += power[(size_t)bin] / (double)totalFrames;
+    }
+
+    return true;
+}
+
+std::vector<double> MatchEQ::reduceToGrid(const Spectrum& spectrum, const std::vector<double>& frequencies) const
+{
+    const auto numBins = (int)spectrum.power.size();
+    const auto binWidth = spectrum.sampleRate / (double)(1 << fftOrder);
+    const auto halfBand = std::exp2(1.0 / 12.0);
+
+    std::vector<double> result(frequencies.size());
+
+    for (size_t i = 0; i < frequencies.size(); ++i)
+    {
+        //1/6 octave around every grid point, so the fit doesn't chase bin noise
+        auto first = juce::jlimit(1, numBins - 1, (int)std::ceil(frequencies[i] / halfBand / binWidth));
+        auto last = juce::jlimit(1, numBins - 1, (int)std::floor(frequencies[i] * halfBand / binWidth));
+
+        if (last >= first)
+        {
+            double sum = 0.0;
+            for (int bin = first; bin <= last; ++bin)
+                sum += spectrum.power[(size_t)bin];
+            result[i] = sum / (double)(last - first + 1);
+        }
+        else
+        {
+            //lower than the bin spacing, interpolate the two neighbours
+            auto position = frequencies[i] / binWidth;
+            auto lower = juce::jlimit(0, numBins - 2, (int)position);
+            auto proportion = juce::jlimit(0.0, 1.0, position - lower);
+            result[i] = juce::jmap(proportion, spectrum.power[(size_t)lower], spectrum.power[(size_t)lower + 1]);
+        }
+    }
+
+    return result;
+}
+
+MatchEQResult MatchEQ::fit(const std::vector<double>& differenceInDecibels, double sampleRate, double maxFrequency)
+{
+    FilterResponse response;
+    response.setFrequencies(FilterResponse::makeLogFrequencies(numGridPoints, 20.0, maxFrequency), sampleRate);
+    const auto& frequencies = response.getFrequencies();
+
+    //the peak starts on the largest deviation inside the audible mid range
+    const auto upperStart = juce::jmin(16000.0, 0.8 * maxFrequency);
+    Vertex start{std::log2(40.0), std::log2(1000.0), 0.0, 0.0, std::log2(upperStart)};
+    double largest = 0.0;
+    for (size_t i = 0; i < frequencies.size(); ++i)
+    {
+        if (frequencies[i] > 40.0 && frequencies[i] < upperStart && std::abs(differenceInDecibels[i]) > largest)
+        {
+            largest = std::abs(differenceInDecibels[i]);
+            start[1] = std::log2(frequencies[i]);
+            start[2] = juce::jlimit(-24.0, 24.0, differenceInDecibels[i]);
+        }
+    }
+    const Vertex steps{1.5, 1.0, 3.0, 0.5, 1.5};
+
+    //every bypass / slope combination of the two cut filters
+    constexpr int numCutOptions = 5;
+    constexpr int numCombinations = numCutOptions * numCutOptions;
+
+    std::array<double, numCombinations> costs;
+    std::array<ChainSettings, numCombinations> candidates;
+
+    runInParallel(numCombinations, [&](int combination)
+    {
+        ChainSettings base;
+        auto lowOption = combination % numCutOptions;
+        auto highOption = combination / numCutOptions;
+
+        base.lowCutBypass = lowOption == 0;
+        base.LowCutSlope = static_cast<Slope>(juce::jmax(0, lowOption - 1));
+        base.highCutBypass = highOption == 0;
+        base.HighCutSlope = static_cast<Slope>(juce::jmax(0, highOption - 1));
+        base.peakBypass = false;
+
+        std::vector<double> magnitudes(frequencies.size());
+        auto cost = [&](const Vertex& x)
+        {
+            return evaluate(decode(x, base, maxFrequency), sampleRate, response, differenceInDecibels, magnitudes);
+        };
+
+        double bestCost = 0.0;
+        auto best = nelderMead(cost, start, steps, bestCost, [this] { return isCancelled(); });
+
+        candidates[(size_t)combination] = decode(best, base, maxFrequency);
+        costs[(size_t)combination] = bestCost;
+    });
+
+    MatchEQResult result;
+    if (isCancelled())
+    {
+        result.errorMessage = "Cancelled";
+        return result;
+    }
+
+    auto best = std::min_element(costs.begin(), costs.end()) - costs.begin();
+
+    result.succeeded = true;
+    result.settings = candidates[(size_t)best];
+    result.rmsErrorInDecibels = (float)std::sqrt(costs[(size_t)best]);
+    return result;
+}
+
+void MatchEQ::runInParallel(int numJobs, const std::function<void(int)>& job)
+{
+    std::atomic<int> remaining{numJobs};
+    juce::WaitableEvent finished;
+
+    for (int i = 0; i < numJobs; ++i)
+    {
+        pool.addJob([&job, &remaining, &finished, i]
+        {
+            job(i);
+
+            if (--remaining == 0)
+                finished.signal();
+        });
+    }
+
+    if (numJobs > 0)
+        finished.wait();
+}
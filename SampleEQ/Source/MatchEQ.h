@@ -0,0 +1,71 @@
+/*
+  ==============================================================================
+
+    MatchEQ.h
+    Created: 19 Oct 2026 1:35:52pm
+    Author:  tyzTang
+
+  ==============================================================================
+*/
+
+#pragma once
+#include <JuceHeader.h>
+
+#include "PluginProcessor.h"
+
+struct MatchEQResult
+{
+    bool succeeded = false;
+    juce::String errorMessage;
+
+    ChainSettings settings;
+    float rmsErrorInDecibels = 0.f;
+};
+
+/*
+ Offline fit of the LowCut / Peak / HighCut settings that turn the long-term
+ average spectrum of 'target' into the one of 'reference'.
+
+ Both files are split into chunks analysed in parallel on a thread pool with
+ the same window + frequency-only FFT as FFTDataGenerator. Every slope /
+ bypass combination is then fitted with Nelder-Mead in parallel, candidates
+ being scored with the vectorised FilterResponse evaluator.
+
+ Blocking, call it from a background thread. 'shouldExit' is polled between
+ chunks and fit iterations, a match it stops fails with "Cancelled".
+ */
+class MatchEQ
+{
+public:
+    MatchEQ();
+
+    MatchEQResult match(const juce::File& reference, const juce::File& target, double sampleRate,
+                        std::function<bool()> shouldExit = nullptr);
+
+    static constexpr int fftOrder = 12;
+    static constexpr int numGridPoints = 256;
+    static constexpr int framesPerChunk = 256;
+
+private:
+    struct Spectrum
+    {
+        std::vector<double> power;
+        double sampleRate = 0.0;
+        int numFrames = 0;
+    };
+
+    bool analyseFile(const juce::File& file, Spectrum& spectrum, juce::String& errorMessage);
+    std::vector<double> reduceToGrid(const Spectrum& spectrum, const std::vector<double>& frequencies) const;
+    //grid and cutoffs stay at or below maxFrequency, under the Nyquist frequency of every rate involved
+    MatchEQResult fit(const std::vector<double>& differenceInDecibels, double sampleRate, double maxFrequency);
+
+    //runs job(0 .. numJobs-1) on the pool and waits for all of them
+    void runInParallel(int numJobs, const std::function<void(int)>& job);
+
+    bool isCancelled() const { return shouldExit != nullptr && shouldExit(); }
+
+    std::function<bool()> shouldExit;
+
+    juce::AudioFormatManager formatManager;
+    juce::ThreadPool pool;
+};
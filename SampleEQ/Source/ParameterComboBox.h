@@ -0,0 +1,29 @@
+/*
+  ==============================================================================
+
+    ParameterComboBox.h
+    Created: 19 Oct 2026 10:02:17am
+    Author:  tyzTang
+
+  ==============================================================================
+*/
+
+#pragma once
+#include <JuceHeader.h>
+
+/*
+ fills itself from the choices of the parameter, so a ComboBoxAttachment
+ declared after it sees the items straight away
+ */
+struct ParameterComboBox : juce::ComboBox
+{
+    ParameterComboBox(juce::RangedAudioParameter& rap)
+    {
+        if (auto* choice = dynamic_cast<juce::AudioParameterChoice*>(&rap))
+            addItemList(choice->choices, 1);
+
+        setTooltip(rap.getName(64));
+    }
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(ParameterComboBox)
+};
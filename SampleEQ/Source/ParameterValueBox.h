@@ -0,0 +1,28 @@
+/*
+  ==============================================================================
+
+    ParameterValueBox.h
+    Created: 19 Oct 2026 11:41:05pm
+    Author:  tyzTang
+
+  ==============================================================================
+*/
+
+#pragma once
+#include <JuceHeader.h>
+
+/*
+ a float parameter as a one-line bar, for settings rows where a rotary
+ doesn't fit; drag it or double click to type the value
+ */
+struct ParameterValueBox : juce::Slider
+{
+    ParameterValueBox(juce::RangedAudioParameter& rap, const juce::String& unitSuffix) :
+        juce::Slider(juce::Slider::LinearBar, juce::Slider::TextBoxLeft)
+    {
+        setTextValueSuffix(" " + unitSuffix);
+        setTooltip(rap.getName(64));
+    }
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(ParameterValueBox)
+};
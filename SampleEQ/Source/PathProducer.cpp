@@ -10,29 +10,286 @@
 
 #include "PathProducer.h"
 
-void PathProducer::process(juce::Rectangle<float> fftBounds, double sampleRate)
+void PathProducer::setAnalysisSettings(const AnalysisSettings& settings)
 {
-    juce::AudioBuffer<float> tempIncomingBuffer;
+    //only the tap that is shown gets published by the audio thread
+    if (settings.tap != listenedTap)
+    {
+        if (enabled)
+        {
+            analyzerTaps->addListener(settings.tap);
+            analyzerTaps->removeListener(listenedTap);
+        }
+
+        listenedTap = settings.tap;
+    }
+
+    const juce::SpinLock::ScopedLockType sl(settingsLock);
+    analysisSettings = settings;
+}
+
+void PathProducer::setEnabled(bool shouldBeEnabled)
+{
+    if (shouldBeEnabled == enabled)
+        return;
+
+    enabled = shouldBeEnabled;
+
+    if (enabled)
+    {
+        needsWarmUp = true;
+        analyzerTaps->addListener(listenedTap);
+        worker->addClient(this);
+    }
+    else
+    {
+        //returns once the worker is done with us, the engine is ours to free
+        worker->removeClient(this);
+        analyzerTaps->removeListener(listenedTap);
+
+        engine.reset();
+        engineBytes = 0;
+    }
+}
+
+bool PathProducer::pullPaths()
+{
+    /*
+    while there are paths that can be pll
+    pull as many as we can
+    display the most recent path
+    */
+
+    bool gotNewPath = false;
+
+    for (int channel = 0; channel < 2; ++channel)
+    {
+        while (pathProducers[channel].getNumPathsAvailable())
+        {
+            gotNewPath = pathProducers[channel].getPath(ChannelFFTPaths[channel]) || gotNewPath;
+        }
+    }
+
+    if (gotNewPath)
+        ++framesDisplayed;
+
+    return gotNewPath;
+}
+
+PathProducer::FrameCounters PathProducer::getFrameCounters() const
+{
+    FrameCounters counters;
+    counters.framesComputed = framesComputed.load();
+    counters.framesSkipped = framesSkipped.load();
+    counters.framesDisplayed = framesDisplayed.load();
+    return counters;
+}
+
+void PathProducer::analyse()
+{
+    AnalysisSettings settings;
+
+    {
+        const juce::SpinLock::ScopedLockType sl(settingsLock);
+        settings = analysisSettings;
+    }
+
+    //nothing to draw into yet
+    if (settings.fftBounds.isEmpty() || settings.sampleRate <= 0.0)
+        return;
+
+    //prepareToPlay may reallocate the ring, not while this pass reads it
+    const AnalyzerTapTransport::ScopedRead scopedRead(*analyzerTaps);
+
+    const auto order = getEngineOrder(settings);
+    if (engine == nullptr || engine->fftDataGenerator.getFFTSize() != (1 << order) || engine->mode != settings.mode)
+        rebuildEngine(order, settings.mode);
+
+    //a new region only needs a new front end, averages of the old one don't apply
+    if (auto& downmixer = engine->downmixer;
+        settings.mode == AnalyzerMode_Zoom
+        && !downmixer.isPreparedFor(settings.sampleRate, settings.zoomLowFrequency, settings.zoomHighFrequency,
+                                    engine->fftDataGenerator.getFFTSize()))
+    {
+        downmixer.prepare(settings.sampleRate, settings.zoomLowFrequency, settings.zoomHighFrequency,
+                          engine->fftDataGenerator.getFFTSize());
+        engine->fftDataGenerator.resetAveraging(settings.averaging, -48.0f);
+        engineBytes = engine->getMemoryUsage();
+        samplesSinceLastFrame = 0;
+    }
+
+    //samples counted at another rate aren't seconds at this one
+    if (settings.sampleRate != timestampSampleRate)
+    {
+        timestampSampleRate = settings.sampleRate;
+        samplesAnalysed = 0;
+    }
+
+    if (needsWarmUp.exchange(false))
+        warmUp(settings);
+
+    process(settings);
+}
+
+void PathProducer::warmUp(const AnalysisSettings& settings)
+{
+    auto& stereoBuffer = engine->stereoBuffer;
+    auto& fftDataGenerator = engine->fftDataGenerator;
+
+    //whatever is left in the ring is from before the analyzer was switched off
+    if (const auto numStale = analyzerTaps->getNumReady(); numStale > 0)
+        analyzerTaps->read(settings.tap, stereoBuffer, 0, numStale, 0);
+
+    stereoBuffer.clear();
+    engine->lowBandBuffer.clear();
+    engine->decimator.reset();
+    engine->downmixer.reset();
+    fftDataGenerator.resetAveraging(settings.averaging, -48.0f);
+
+    //the first new block is transformed right away instead of waiting for a full hop
+    samplesSinceLastFrame = getHopSize(settings);
+}
+
+int PathProducer::getHopSize(const AnalysisSettings& settings) const
+{
+    //in input samples, a zoom window spans 'factor' times its size
+    auto windowSpan = engine->fftDataGenerator.getFFTSize();
+    if (engine->mode == AnalyzerMode_Zoom)
+        windowSpan *= engine->downmixer.getFactor();
+
+    return juce::jmax(1, windowSpan / juce::jmax(1, settings.overlap));
+}
 
+void PathProducer::rebuildEngine(FFTOrder order, AnalyzerMode mode)
+{
+    auto newEngine = std::make_unique<AnalysisEngine>(order, mode);
 
-    while (ChannelFifo->getNumCompleteBuffersAvailable() > 0)
+    //carry the newest audio over so the display doesn't drop out
+    if (engine != nullptr)
     {
-        if (ChannelFifo->getAudioBuffer(tempIncomingBuffer))
+        const auto& oldBuffer = engine->stereoBuffer;
+        auto& newBuffer = newEngine->stereoBuffer;
+        const auto numToKeep = juce::jmin(oldBuffer.getNumSamples(), newBuffer.getNumSamples());
+
+        for (int channel = 0; channel < 2; ++channel)
+            newBuffer.copyFrom(channel, newBuffer.getNumSamples() - numToKeep,
+                               oldBuffer, channel, oldBuffer.getNumSamples() - numToKeep, numToKeep);
+    }
+
+    engine.swap(newEngine);
+    engineBytes = engine->getMemoryUsage();
+    samplesSinceLastFrame = 0;
+}
+
+//appends the last 'numSamples' of 'source' to 'window', its oldest samples slide out
+static void slideIntoWindow(juce::AudioBuffer<float>& window, const juce::AudioBuffer<float>& source, int numSamples)
+{
+    const auto windowSize = window.getNumSamples();
+    const auto size = juce::jmin(numSamples, windowSize);
+
+    for (int channel = 0; channel < 2; ++channel)
+    {
+        auto* data = window.getWritePointer(channel);
+        std::memmove(data, data + size, (size_t)(windowSize - size) * sizeof(float));
+        std::memcpy(data + windowSize - size, source.getReadPointer(channel, numSamples - size), (size_t)size * sizeof(float));
+    }
+}
+
+void PathProducer::readIncoming(const AnalysisSettings& settings, int numIncoming)
+{
+    auto& stereoBuffer = engine->stereoBuffer;
+
+    //only the newest window's worth is copied
+    const auto windowSize = stereoBuffer.getNumSamples();
+    const auto size = juce::jmin(numIncoming, windowSize);
+
+    for (int channel = 0; channel < 2; ++channel)
+    {
+        juce::FloatVectorOperations::copy(
+            stereoBuffer.getWritePointer(channel, 0),
+            stereoBuffer.getReadPointer(channel, size),
+            windowSize - size
+        );
+    }
+    analyzerTaps->read(settings.tap, stereoBuffer, windowSize - size, numIncoming - size, size);
+}
+
+void PathProducer::readIncomingDecimated(const AnalysisSettings& settings, int numIncoming)
+{
+    auto& e = *engine;
+    const auto zoom = e.mode == AnalyzerMode_Zoom;
+
+    //the decimated window spans 'factor' windows of input, anything older can't show up in it
+    const auto chunkSize = e.incoming.getNumSamples();
+    const auto windowSpan = zoom ? e.downmixer.getBaseband().getNumSamples() * e.downmixer.getFactor()
+                                 : chunkSize * e.decimator.getFactor();
+    const auto numToRead = juce::jmin(numIncoming, windowSpan);
+    auto numToSkip = numIncoming - numToRead;
+
+    //every sample goes through the decimator, a window at a time
+    for (int numRead = 0; numRead < numToRead;)
+    {
+        const auto size = juce::jmin(chunkSize, numToRead - numRead);
+        analyzerTaps->read(settings.tap, e.incoming, 0, numToSkip, size);
+        numToSkip = 0;
+        numRead += size;
+
+        if (zoom)
         {
-            auto size = tempIncomingBuffer.getNumSamples();
-            juce::FloatVectorOperations::copy(
-                monoBuffer.getWritePointer(0, 0),
-                monoBuffer.getReadPointer(0, size),
-                monoBuffer.getNumSamples() - size
-            );
-            juce::FloatVectorOperations::copy(
-                monoBuffer.getWritePointer(0, monoBuffer.getNumSamples() - size),
-                tempIncomingBuffer.getReadPointer(0, 0),
-                size
-            );
-
-            ChannelFFTDataGenerator.produceFFTDataForRendering(monoBuffer, -48.0f);
+            e.downmixer.process(e.incoming, size);
+            continue;
         }
+
+        slideIntoWindow(e.stereoBuffer, e.incoming, size);
+
+        const auto numDecimated = e.decimator.process(e.incoming.getArrayOfReadPointers(), size,
+                                                      e.decimated.getArrayOfWritePointers());
+        slideIntoWindow(e.lowBandBuffer, e.decimated, numDecimated);
+    }
+}
+
+void PathProducer::process(const AnalysisSettings& settings)
+{
+    auto& stereoBuffer = engine->stereoBuffer;
+    auto& fftDataGenerator = engine->fftDataGenerator;
+    const auto multiResolution = engine->mode == AnalyzerMode_MultiResolution;
+    const auto zoom = engine->mode == AnalyzerMode_Zoom;
+
+    const auto hopSize = getHopSize(settings);
+
+    //everything that arrived since the last pass
+    if (const auto numIncoming = analyzerTaps->getNumReady(); numIncoming > 0)
+    {
+        if (multiResolution || zoom)
+            readIncomingDecimated(settings, numIncoming);
+        else
+            readIncoming(settings, numIncoming);
+
+        samplesSinceLastFrame += numIncoming;
+        samplesAnalysed += (juce::uint64)numIncoming;
+    }
+
+    //only the newest window is transformed, hops that piled up since the last pass are coalesced into it
+    if (samplesSinceLastFrame >= hopSize)
+    {
+        const auto dueFrames = samplesSinceLastFrame / hopSize;
+        samplesSinceLastFrame %= hopSize;
+
+        //the time constants follow the audio that went by, not the number of frames
+        const auto elapsedSeconds = float(dueFrames * hopSize / settings.sampleRate);
+
+        SpectrumAveraging averaging;
+        averaging.mode = settings.averaging;
+        averaging.weight = 1.f - std::exp(-elapsedSeconds / averagingTimeInSeconds);
+        averaging.decayInDecibels = peakDecayInDecibelsPerSecond * elapsedSeconds;
+
+        fftDataGenerator.setSmoothing(settings.smoothingBandsPerOctave);
+        fftDataGenerator.produceFFTDataForRendering(zoom ? engine->downmixer.getBaseband() : stereoBuffer,
+                                                    -48.0f, averaging,
+                                                    multiResolution ? &engine->lowBandBuffer : nullptr);
+
+        ++framesComputed;
+        framesSkipped += (juce::uint64)(dueFrames - 1);
     }
 
     /*
@@ -41,39 +298,42 @@ void PathProducer::process(juce::Rectangle<float> fftBounds, double sampleRate)
   generate apth
    */
 
-    // const auto fftBounds =bounds.toFloat();
-    const auto fftSize = ChannelFFTDataGenerator.getFFTSize();
+    //in multi-resolution the bins are those of the low band, see StereoFFTDataGenerator::stitchBands
+    const auto fftSize = fftDataGenerator.getFrameSize();
 
 
     /*
      48000/4048 = =23hz this is the bin width
      */
 
-    const auto binWidth = sampleRate / (double)fftSize;
+    auto binWidth = settings.sampleRate / (double)fftSize;
+    auto startFrequency = 0.f;
 
-    //have data block
-    while (ChannelFFTDataGenerator.getNumAvailableFFTDataBlocks() > 0)
+    //zoom bins are those of the baseband, around the centre of the region
+    if (zoom)
     {
-        std::vector<float> fftData;
-        //can get the fft data
-        if (ChannelFFTDataGenerator.getFFTData(fftData))
-        {
-            pathProducer.generatePath(fftData, fftBounds, fftSize, binWidth, -48.0f);
-        }
+        const auto basebandRate = engine->downmixer.getBasebandSampleRate();
+        binWidth = basebandRate / (double)fftSize;
+        startFrequency = engine->downmixer.getCentreFrequency() - float(basebandRate / 4.0);
     }
 
-    // leftChannelFFTPath.
-
-    /*
-    while there are paths that can be pll
-    pull as many as we can
-    display the most recent path
-    */
+    const auto numSpectrogramRows = spectrogramRows.load();
 
-    while (pathProducer.getNumPathsAvailable())
+    //have data block, read in place; one frame holds both channels
+    while (auto* fftData = fftDataGenerator.acquireFFTData())
     {
-        pathProducer.getPath(ChannelFFTPath);
-    }
+        for (int channel = 0; channel < 2; ++channel)
+            pathProducers[channel].generatePath(fftData->data() + channel * (fftSize / 2),
+                                                settings.fftBounds, fftSize, (float)binWidth, -48.0f, startFrequency);
 
-    
+        if (numSpectrogramRows > 0)
+            spectrogramGenerator.generateColumn(fftData->data(), fftSize, (float)binWidth, numSpectrogramRows,
+                                                startFrequency, -48.0f);
+
+        //recordings are full band frames, their header has no room for a region
+        if (!zoom)
+            recorder.pushFrame(fftData->data(), fftSize, settings.sampleRate, (double)samplesAnalysed / settings.sampleRate);
+
+        fftDataGenerator.releaseFFTData();
+    }
 }
@@ -12,28 +12,182 @@
 #include "PluginProcessor.h"
 #include "SingleChannelSampleFifo.h"
 
-struct PathProducer
+#include "AnalyzerTapTransport.h"
+#include "AnalyzerWorker.h"
+#include "Decimator.h"
+#include "ZoomDownmixer.h"
+#include "SpectrumRecorder.h"
+
+/*
+ Both channels of the analyzer, from one tap of the transport through one complex FFT.
+ The FFTs and paths are computed on the shared AnalyzerWorker thread, the
+ message thread only sets the target area and picks up finished paths.
+ */
+struct PathProducer : AnalyzerWorker::Client
 {
-    PathProducer(SingleChannelSampleFifo<SampleEQAudioProcessor::BlockType>& scsf): ChannelFifo(&scsf)
+    PathProducer(AnalyzerTapTransport& transport): analyzerTaps(&transport)
     {
         
         /*
          48000/4048 = =23hz
+         the engine is built by the first pass, at the order that is asked for
          */
 
-        ChannelFFTDataGenerator.changeOrder(FFTOrder::order2048);
-        monoBuffer.setSize(1, ChannelFFTDataGenerator.getFFTSize());
+        analyzerTaps->addListener(listenedTap);
+        worker->addClient(this);
+    }
+
+    ~PathProducer() override
+    {
+        if (enabled)
+        {
+            worker->removeClient(this);
+            analyzerTaps->removeListener(listenedTap);
+        }
     }
-    void process(juce::Rectangle<float> fftBounds, double sampleRate);
-    juce::Path getPath() { return ChannelFFTPath; }
+
+    struct AnalysisSettings
+    {
+        juce::Rectangle<float> fftBounds;
+        double sampleRate = 0.0;
+        int overlap = 4; //FFT size / hop size
+        FFTOrder order = FFTOrder::order2048;
+        SpectrumAveraging::Mode averaging = SpectrumAveraging::Off;
+        int smoothingBandsPerOctave = 0; //fractional-octave smoothing, 0 = off
+        AnalyzerMode mode = AnalyzerMode_FullBand;
+        float zoomLowFrequency = 40.f, zoomHighFrequency = 120.f; //the region of AnalyzerMode_Zoom
+        AnalyzerTap tap = AnalyzerTap_Post;
+    };
+
+    struct FrameCounters
+    {
+        juce::uint64 framesComputed = 0; //FFTs actually run
+        juce::uint64 framesSkipped = 0; //hops coalesced into a newer frame
+        juce::uint64 framesDisplayed = 0; //paths the message thread picked up
+    };
+
+    //message thread
+    void setAnalysisSettings(const AnalysisSettings& settings);
+
+    /*
+     While disabled the tap has no listener from here, so the audio thread
+     doesn't publish it for us, the worker doesn't run this producer and the
+     FFT buffers are freed. Enabling again drops the stale audio and shows a
+     frame from the first new block.
+     */
+    void setEnabled(bool shouldBeEnabled);
+    bool pullPaths();
+    FrameCounters getFrameCounters() const;
+
+    //indexed like the buffer channels, see Channel
+    juce::Path getPath(Channel channel) { return ChannelFFTPaths[channel]; }
+
+    //spectrogram columns are only produced while a display asks for them, 0 = none
+    void setSpectrogramRows(int numRows) { spectrogramRows = numRows; }
+    const SpectrogramColumn* acquireSpectrogramColumn() { return spectrogramGenerator.acquireColumn(); }
+    void releaseSpectrogramColumn() { spectrogramGenerator.releaseColumn(); }
+
+    //every analyzer frame is also handed to the recorder while it is recording
+    SpectrumRecorder& getRecorder() { return recorder; }
+
+    //bytes held by the FFT engine, 0 until the first pass and while disabled
+    size_t getMemoryUsage() const { return engineBytes.load(); }
 
 private:
-    juce::AudioBuffer<float> monoBuffer;
+    /*
+     Everything that depends on the FFT order and the mode. Only the worker
+     thread touches it, so a new one is built there and swapped in between two
+     passes; the old engine and all its buffers are freed right away. Disabling
+     frees it on the message thread once the worker has let go of this producer.
+     */
+    struct AnalysisEngine
+    {
+        AnalysisEngine(FFTOrder order, AnalyzerMode engineMode) : mode(engineMode)
+        {
+            fftDataGenerator.changeOrder(order, getDefaultFFTBackend(), mode);
+
+            const auto fftSize = fftDataGenerator.getFFTSize();
+            stereoBuffer.setSize(2, fftSize);
+            stereoBuffer.clear();
+
+            //the downmixer is prepared by the worker, it depends on the region
+            if (mode == AnalyzerMode_Zoom)
+                incoming.setSize(2, fftSize);
+
+            if (mode == AnalyzerMode_MultiResolution)
+            {
+                const auto factor = StereoFFTDataGenerator<std::vector<float>>::decimation;
+
+                //passband flat up to the crossover, what aliases lands above it
+                decimator.prepare(2, factor, 16, 0.5 / factor);
+                lowBandBuffer.setSize(2, fftSize);
+                lowBandBuffer.clear();
+                incoming.setSize(2, fftSize);
+                decimated.setSize(2, fftSize / factor + 1);
+            }
+        }
+
+        size_t getMemoryUsage() const
+        {
+            size_t samples = 0;
+            for (const auto* buffer : {&stereoBuffer, &lowBandBuffer, &incoming, &decimated})
+                samples += (size_t)buffer->getNumChannels() * (size_t)buffer->getNumSamples();
+
+            return fftDataGenerator.getMemoryUsage() + samples * sizeof(float) + decimator.getMemoryUsage()
+                   + downmixer.getMemoryUsage();
+        }
+
+        const AnalyzerMode mode;
+        StereoFFTDataGenerator<std::vector<float>> fftDataGenerator;
+        juce::AudioBuffer<float> stereoBuffer;
+
+        //multi-resolution only: the decimated window and what feeds it; 'incoming' is also used by zoom
+        juce::AudioBuffer<float> lowBandBuffer, incoming, decimated;
+        Decimator decimator;
+
+        //zoom only
+        ZoomDownmixer downmixer;
+    };
+
+    //zoom runs a transform 4 times smaller than the resolution asks for, its bins are still far narrower
+    static FFTOrder getEngineOrder(const AnalysisSettings& settings)
+    {
+        return settings.mode == AnalyzerMode_Zoom ? static_cast<FFTOrder>(settings.order - 2) : settings.order;
+    }
+
+    //worker thread
+    void analyse() override;
+    void process(const AnalysisSettings& settings);
+    void readIncoming(const AnalysisSettings& settings, int numIncoming);
+    void readIncomingDecimated(const AnalysisSettings& settings, int numIncoming);
+    int getHopSize(const AnalysisSettings& settings) const;
+    void rebuildEngine(FFTOrder order, AnalyzerMode mode);
+    void warmUp(const AnalysisSettings& settings);
+
+    AnalyzerTapTransport* analyzerTaps;
+    AnalyzerTap listenedTap = AnalyzerTap_Post; //message thread
+    bool enabled = true; //message thread
+    std::atomic<bool> needsWarmUp{true}; //the ring may still hold audio from a closed editor
+    std::unique_ptr<AnalysisEngine> engine;
+    std::atomic<size_t> engineBytes{0};
+    AnalyzerPathGenerator<juce::Path> pathProducers[2];
+    SpectrogramColumnGenerator spectrogramGenerator;
+    std::atomic<int> spectrogramRows{0};
+    SpectrumRecorder recorder;
+
+    juce::SpinLock settingsLock;
+    AnalysisSettings analysisSettings;
+
+    int samplesSinceLastFrame = 0;
+    juce::uint64 samplesAnalysed = 0; //timestamps of recorded frames, at timestampSampleRate
+    double timestampSampleRate = 0.0;
+
+    static constexpr float averagingTimeInSeconds = 0.3f;
+    static constexpr float peakDecayInDecibelsPerSecond = 12.f;
+    std::atomic<juce::uint64> framesComputed{0}, framesSkipped{0}, framesDisplayed{0};
 
-    SingleChannelSampleFifo<SampleEQAudioProcessor::BlockType>* ChannelFifo;
-    FFTDataGenerator<std::vector<float>> ChannelFFTDataGenerator;
-    AnalyzerPathGenerator<juce::Path> pathProducer;
+    //message thread only
+    juce::Path ChannelFFTPaths[2];
 
-    juce::Path ChannelFFTPath;
-    SingleChannelSampleFifo<SampleEQAudioProcessor::BlockType>* rightChannelFifo;
+    juce::SharedResourcePointer<AnalyzerWorker> worker;
 };
@@ -15,6 +15,7 @@
 SampleEQAudioProcessorEditor::SampleEQAudioProcessorEditor(SampleEQAudioProcessor& p)
     : AudioProcessorEditor(&p), audioProcessor(p),
       responseCurveComponent(audioProcessor),
+      spectrogramComponent(responseCurveComponent.getPathProducer()),
       peakFreqSlider(*audioProcessor.apvts.getParameter("Peak Freq"), "Hz"),
       peakGainSlider(*audioProcessor.apvts.getParameter("Peak Gain"), "dB"),
       peakQualitySlider(*audioProcessor.apvts.getParameter("Peak Quality"), ""),
@@ -34,7 +35,34 @@ SampleEQAudioProcessorEditor::SampleEQAudioProcessorEditor(SampleEQAudioProcesso
       lowCutBypassButtonAttachment(audioProcessor.apvts, lowCutBypass, lowCutBypassButton),
       peakBypassButtonAttachment(audioProcessor.apvts, peakByPass, peakBypassButton),
       highCutBypassButtonAttachment(audioProcessor.apvts, highCutBypass, highCutBypassButton),
-      analyzerEnableButtonAttachment(audioProcessor.apvts, analyzerByPass, analyzerEnableButton)
+      analyzerEnableButtonAttachment(audioProcessor.apvts, analyzerByPass, analyzerEnableButton),
+
+      eqModeComboBox(*audioProcessor.apvts.getParameter(eqMode)),
+      spectralResolutionComboBox(*audioProcessor.apvts.getParameter(spectralResolution)),
+      autoGainComboBox(*audioProcessor.apvts.getParameter(autoGainMode)),
+      analyzerOverlapComboBox(*audioProcessor.apvts.getParameter(analyzerOverlap)),
+      analyzerResolutionComboBox(*audioProcessor.apvts.getParameter(analyzerResolution)),
+      analyzerAveragingComboBox(*audioProcessor.apvts.getParameter(analyzerAveraging)),
+      analyzerOctaveSmoothingComboBox(*audioProcessor.apvts.getParameter(analyzerOctaveSmoothing)),
+      analyzerFrameRateComboBox(*audioProcessor.apvts.getParameter(analyzerFrameRate)),
+      analyzerModeComboBox(*audioProcessor.apvts.getParameter(analyzerMode)),
+      analyzerTapComboBox(*audioProcessor.apvts.getParameter(analyzerTap)),
+
+      eqModeComboBoxAttachment(audioProcessor.apvts, eqMode, eqModeComboBox),
+      spectralResolutionComboBoxAttachment(audioProcessor.apvts, spectralResolution, spectralResolutionComboBox),
+      autoGainComboBoxAttachment(audioProcessor.apvts, autoGainMode, autoGainComboBox),
+      analyzerOverlapComboBoxAttachment(audioProcessor.apvts, analyzerOverlap, analyzerOverlapComboBox),
+      analyzerResolutionComboBoxAttachment(audioProcessor.apvts, analyzerResolution, analyzerResolutionComboBox),
+      analyzerAveragingComboBoxAttachment(audioProcessor.apvts, analyzerAveraging, analyzerAveragingComboBox),
+      analyzerOctaveSmoothingComboBoxAttachment(audioProcessor.apvts, analyzerOctaveSmoothing,
+                                                analyzerOctaveSmoothingComboBox),
+      analyzerFrameRateComboBoxAttachment(audioProcessor.apvts, analyzerFrameRate, analyzerFrameRateComboBox),
+      analyzerModeComboBoxAttachment(audioProcessor.apvts, analyzerMode, analyzerModeComboBox),
+      analyzerTapComboBoxAttachment(audioProcessor.apvts, analyzerTap, analyzerTapComboBox),
+      analyzerZoomLowBox(*audioProcessor.apvts.getParameter(analyzerZoomLow), "Hz"),
+      analyzerZoomHighBox(*audioProcessor.apvts.getParameter(analyzerZoomHigh), "Hz"),
+      analyzerZoomLowBoxAttachment(audioProcessor.apvts, analyzerZoomLow, analyzerZoomLowBox),
+      analyzerZoomHighBoxAttachment(audioProcessor.apvts, analyzerZoomHigh, analyzerZoomHighBox)
 {
     // Make sure that before the constructor has finished, you've set the
     // editor's size to whatever you need it to be.
@@ -106,19 +134,179 @@ SampleEQAudioProcessorEditor::SampleEQAudioProcessorEditor(SampleEQAudioProcesso
         }
     };
 
+    //the attachment has set the button already, the analyzer only listens when it is shown
+    responseCurveComponent.toggleAnalysisEnableemet(!analyzerEnableButton.getToggleState());
+
+
+    matchButton.setTooltip("Fit LowCut / Peak / HighCut so a target file matches a reference file");
+    matchButton.onClick = [safePtr]
+    {
+        if (auto* comp = safePtr.getComponent())
+            comp->launchMatchEQ();
+    };
+
+    recordButton.setTooltip("Write the analyzer spectra to a file until stopped, not in Zoom mode");
+    recordButton.onClick = [safePtr]
+    {
+        if (auto* comp = safePtr.getComponent())
+            comp->toggleSpectrumRecording();
+    };
+
+    responseCurveComponent.getPathProducer().getRecorder().onEndedEarly = [safePtr]
+    {
+        juce::MessageManager::callAsync([safePtr]
+        {
+            if (auto* comp = safePtr.getComponent())
+            {
+                //unless a new recording was started meanwhile
+                if (auto& recorder = comp->responseCurveComponent.getPathProducer().getRecorder(); !recorder.isRecording())
+                {
+                    recorder.stop();
+                    comp->recordButton.setButtonText("Record");
+                }
+
+                juce::AlertWindow::showMessageBoxAsync(juce::MessageBoxIconType::WarningIcon, "Record",
+                                                       "The analyzer FFT size or sample rate changed, the recording was ended");
+            }
+        });
+    };
+
+    //the attachment reports host changes to the box as well
+    analyzerModeComboBox.onChange = [safePtr]
+    {
+        if (auto* comp = safePtr.getComponent())
+            comp->updateRecordButton();
+    };
+    updateRecordButton();
 
     
-    setSize(600, 400);
+    setSize(600, 515);
 }
 
 SampleEQAudioProcessorEditor::~SampleEQAudioProcessorEditor()
 {
+    //the fit polls threadShouldExit(), the file analysis and every fit iteration are short
+    matchThread.stopThread(10000);
+
     peakBypassButton.setLookAndFeel(nullptr);
     lowCutBypassButton.setLookAndFeel(nullptr);
     highCutBypassButton.setLookAndFeel(nullptr);
     analyzerEnableButton.setLookAndFeel(nullptr);
 }
 
+void SampleEQAudioProcessorEditor::launchMatchEQ()
+{
+    //reference first, then the target, then fit on a background thread
+    auto safePtr = juce::Component::SafePointer<SampleEQAudioProcessorEditor>(this);
+    const auto flags = juce::FileBrowserComponent::openMode | juce::FileBrowserComponent::canSelectFiles;
+
+    fileChooser = std::make_unique<juce::FileChooser>("Reference file", juce::File(), "*.wav;*.aiff;*.aif;*.flac");
+    fileChooser->launchAsync(flags, [safePtr, flags](const juce::FileChooser& chooser)
+    {
+        auto* comp = safePtr.getComponent();
+        if (comp == nullptr || chooser.getResult() == juce::File())
+            return;
+
+        comp->matchReferenceFile = chooser.getResult();
+        comp->fileChooser = std::make_unique<juce::FileChooser>("Target file", juce::File(), "*.wav;*.aiff;*.aif;*.flac");
+        comp->fileChooser->launchAsync(flags, [safePtr](const juce::FileChooser& targetChooser)
+        {
+            auto* comp = safePtr.getComponent();
+            if (comp == nullptr || targetChooser.getResult() == juce::File())
+                return;
+
+            //the button stays disabled until the result is in, so the previous run has finished
+            auto& thread = comp->matchThread;
+            thread.stopThread(10000);
+            thread.reference = comp->matchReferenceFile;
+            thread.target = targetChooser.getResult();
+            thread.sampleRate = comp->audioProcessor.getSampleRate();
+
+            comp->matchButton.setEnabled(false);
+            comp->matchButton.setButtonText("Matching...");
+
+            thread.startThread();
+        });
+    });
+}
+
+void SampleEQAudioProcessorEditor::MatchEQThread::run()
+{
+    MatchEQ matchEQ;
+    auto result = matchEQ.match(reference, target, sampleRate, [this] { return threadShouldExit(); });
+
+    //stopped by the destructor, there is nobody to tell
+    if (threadShouldExit())
+        return;
+
+    juce::MessageManager::callAsync([safePtr = editor, result]
+    {
+        if (auto* comp = safePtr.getComponent())
+            comp->applyMatchResult(result);
+    });
+}
+
+void SampleEQAudioProcessorEditor::updateRecordButton()
+{
+    //zoom frames cover one region at another bin spacing, the recorder only takes full band frames
+    const auto zoom = analyzerModeComboBox.getSelectedItemIndex() == AnalyzerMode_Zoom;
+    recordButton.setEnabled(!zoom);
+
+    auto& recorder = responseCurveComponent.getPathProducer().getRecorder();
+    if (zoom && recorder.isRecording())
+    {
+        recorder.stop();
+        recordButton.setButtonText("Record");
+        juce::AlertWindow::showMessageBoxAsync(juce::MessageBoxIconType::WarningIcon, "Record",
+                                               "The zoom analyzer isn't recorded, the recording was ended");
+    }
+}
+
+void SampleEQAudioProcessorEditor::toggleSpectrumRecording()
+{
+    auto& recorder = responseCurveComponent.getPathProducer().getRecorder();
+
+    if (recorder.isRecording())
+    {
+        recorder.stop();
+        recordButton.setButtonText("Record");
+        return;
+    }
+
+    auto safePtr = juce::Component::SafePointer<SampleEQAudioProcessorEditor>(this);
+    const auto flags = juce::FileBrowserComponent::saveMode | juce::FileBrowserComponent::canSelectFiles
+                       | juce::FileBrowserComponent::warnAboutOverwriting;
+
+    fileChooser = std::make_unique<juce::FileChooser>("Record spectra to", juce::File(), "*.seqs");
+    fileChooser->launchAsync(flags, [safePtr](const juce::FileChooser& chooser)
+    {
+        auto* comp = safePtr.getComponent();
+        if (comp == nullptr || chooser.getResult() == juce::File())
+            return;
+
+        auto& recorder = comp->responseCurveComponent.getPathProducer().getRecorder();
+        if (recorder.start(chooser.getResult().withFileExtension("seqs")))
+            comp->recordButton.setButtonText("Stop");
+        else
+            juce::AlertWindow::showMessageBoxAsync(juce::MessageBoxIconType::WarningIcon, "Record",
+                                                   "Couldn't open " + chooser.getResult().getFullPathName());
+    });
+}
+
+void SampleEQAudioProcessorEditor::applyMatchResult(const MatchEQResult& result)
+{
+    matchButton.setEnabled(true);
+    matchButton.setButtonText("Match EQ");
+
+    if (!result.succeeded)
+    {
+        juce::AlertWindow::showMessageBoxAsync(juce::MessageBoxIconType::WarningIcon, "Match EQ", result.errorMessage);
+        return;
+    }
+
+    audioProcessor.applyChainSettings(result.settings);
+}
+
 //==============================================================================
 void SampleEQAudioProcessorEditor::paint(juce::Graphics& g)
 {
@@ -132,11 +320,48 @@ void SampleEQAudioProcessorEditor::resized()
     auto bounds = getLocalBounds();
 
     auto analyzerEnabledArea = bounds.removeFromTop(25);
+
+    auto settingsArea = analyzerEnabledArea.reduced(0, 2);
+    settingsArea.removeFromRight(5);
+    spectralResolutionComboBox.setBounds(settingsArea.removeFromRight(70));
+    settingsArea.removeFromRight(5);
+    eqModeComboBox.setBounds(settingsArea.removeFromRight(90));
+    settingsArea.removeFromRight(5);
+    autoGainComboBox.setBounds(settingsArea.removeFromRight(90));
+    settingsArea.removeFromRight(5);
+    matchButton.setBounds(settingsArea.removeFromRight(80));
+
     analyzerEnabledArea.setWidth(100);
     analyzerEnabledArea.setX(5);
     analyzerEnabledArea.removeFromTop(2);
     analyzerEnableButton.setBounds(analyzerEnabledArea);
 
+    //analyzer settings get their own row, the top one is full
+    auto analyzerSettingsArea = bounds.removeFromTop(25).reduced(0, 2);
+    analyzerSettingsArea.removeFromLeft(5);
+    analyzerOverlapComboBox.setBounds(analyzerSettingsArea.removeFromLeft(60));
+    analyzerSettingsArea.removeFromLeft(5);
+    analyzerResolutionComboBox.setBounds(analyzerSettingsArea.removeFromLeft(65));
+    analyzerSettingsArea.removeFromLeft(5);
+    analyzerAveragingComboBox.setBounds(analyzerSettingsArea.removeFromLeft(95));
+    analyzerSettingsArea.removeFromLeft(5);
+    analyzerOctaveSmoothingComboBox.setBounds(analyzerSettingsArea.removeFromLeft(75));
+    analyzerSettingsArea.removeFromLeft(5);
+    analyzerFrameRateComboBox.setBounds(analyzerSettingsArea.removeFromLeft(70));
+    analyzerSettingsArea.removeFromLeft(5);
+    analyzerTapComboBox.setBounds(analyzerSettingsArea.removeFromLeft(90));
+    analyzerSettingsArea.removeFromLeft(5);
+    recordButton.setBounds(analyzerSettingsArea.removeFromLeft(70));
+
+    //what the analyzer transforms, the zoom region next to it
+    auto analyzerModeArea = bounds.removeFromTop(25).reduced(0, 2);
+    analyzerModeArea.removeFromLeft(5);
+    analyzerModeComboBox.setBounds(analyzerModeArea.removeFromLeft(110));
+    analyzerModeArea.removeFromLeft(5);
+    analyzerZoomLowBox.setBounds(analyzerModeArea.removeFromLeft(90));
+    analyzerModeArea.removeFromLeft(5);
+    analyzerZoomHighBox.setBounds(analyzerModeArea.removeFromLeft(90));
+
     bounds.removeFromTop(5);
 
     
@@ -146,6 +371,10 @@ void SampleEQAudioProcessorEditor::resized()
 
     responseCurveComponent.setBounds(responseArea);
 
+    //lined up with the analysis area of the response curve
+    bounds.removeFromTop(5);
+    spectrogramComponent.setBounds(bounds.removeFromTop(60).reduced(24, 0));
+
     bounds.removeFromTop(5);
     auto lowCutArea = bounds.removeFromLeft(bounds.getWidth() * 0.3f);
     // 66 -> 0.5 = 0.33
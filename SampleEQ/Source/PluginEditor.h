@@ -8,7 +8,11 @@
 
 #pragma once
 #include "ResponseCurveComponent.h"
+#include "SpectrogramComponent.h"
 #include "PowerButton.h"
+#include "ParameterComboBox.h"
+#include "ParameterValueBox.h"
+#include "MatchEQ.h"
 
 //==============================================================================
 /**
@@ -24,6 +28,11 @@ public:
     void resized() override;
 
 private:
+    void launchMatchEQ();
+    void applyMatchResult(const MatchEQResult& result);
+    void toggleSpectrumRecording();
+    void updateRecordButton();
+
     // This reference is provided as a quick way for your editor to
     // access the processor object that created it.
     SampleEQAudioProcessor& audioProcessor;
@@ -32,6 +41,7 @@ private:
 
     // MonoChain monoChain;
     ResponseCurveComponent responseCurveComponent;
+    SpectrogramComponent spectrogramComponent;
 
     RotarySliderWithLabels
         peakFreqSlider,
@@ -66,11 +76,27 @@ private:
             &highCutFreqSlider,
             &highCutSlopeSlider,
             &responseCurveComponent,
+            &spectrogramComponent,
 
             &lowCutBypassButton,
             &peakBypassButton,
             &highCutBypassButton,
             &analyzerEnableButton,
+
+            &eqModeComboBox,
+            &spectralResolutionComboBox,
+            &autoGainComboBox,
+            &matchButton,
+            &recordButton,
+            &analyzerOverlapComboBox,
+            &analyzerResolutionComboBox,
+            &analyzerAveragingComboBox,
+            &analyzerOctaveSmoothingComboBox,
+            &analyzerFrameRateComboBox,
+            &analyzerModeComboBox,
+            &analyzerTapComboBox,
+            &analyzerZoomLowBox,
+            &analyzerZoomHighBox,
         };
     }
 
@@ -84,7 +110,49 @@ private:
         highCutBypassButtonAttachment,
         analyzerEnableButtonAttachment;
 
+    using ComboBoxAttachment = juce::AudioProcessorValueTreeState::ComboBoxAttachment;
+    ParameterComboBox eqModeComboBox, spectralResolutionComboBox, autoGainComboBox, analyzerOverlapComboBox,
+                      analyzerResolutionComboBox, analyzerAveragingComboBox, analyzerOctaveSmoothingComboBox,
+                      analyzerFrameRateComboBox, analyzerModeComboBox, analyzerTapComboBox;
+
+    ComboBoxAttachment
+        eqModeComboBoxAttachment,
+        spectralResolutionComboBoxAttachment,
+        autoGainComboBoxAttachment,
+        analyzerOverlapComboBoxAttachment,
+        analyzerResolutionComboBoxAttachment,
+        analyzerAveragingComboBoxAttachment,
+        analyzerOctaveSmoothingComboBoxAttachment,
+        analyzerFrameRateComboBoxAttachment,
+        analyzerModeComboBoxAttachment,
+        analyzerTapComboBoxAttachment;
+
+    //region of the zoom analyzer
+    ParameterValueBox analyzerZoomLowBox, analyzerZoomHighBox;
+    Attachment analyzerZoomLowBoxAttachment, analyzerZoomHighBoxAttachment;
+
+    juce::TextButton matchButton{"Match EQ"};
+    juce::TextButton recordButton{"Record"};
+    std::unique_ptr<juce::FileChooser> fileChooser;
+    juce::File matchReferenceFile;
+
+    //the fit, owned here and stopped in the destructor so it can't outlive the plugin
+    struct MatchEQThread : juce::Thread
+    {
+        explicit MatchEQThread(SampleEQAudioProcessorEditor& e) : juce::Thread("Match EQ"), editor(&e) {}
+        void run() override;
+
+        juce::Component::SafePointer<SampleEQAudioProcessorEditor> editor;
+        juce::File reference, target;
+        double sampleRate = 0.0;
+    };
+
+    MatchEQThread matchThread{*this};
+
     LookAndFeel lnf;
 
+    //one per process, shows the tooltips of every control and the analyzer's figures
+    juce::SharedResourcePointer<juce::TooltipWindow> tooltipWindow;
+
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(SampleEQAudioProcessorEditor)
 };
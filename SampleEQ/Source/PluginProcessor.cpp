@@ -8,6 +8,7 @@
 
 #include "PluginProcessor.h"
 #include "PluginEditor.h"
+#include "Benchmarks.h"
 #include "pluginterfaces/vst/vsttypes.h"
 
 
@@ -44,10 +45,54 @@ void UpdateCutFilter(ChainType& Chain, const CoefficientType& coefficients,
 }
 
 
+template <int Index>
+void StoreStage(const CutFilter& cutFilter, CutCoefficients& destination)
+{
+    const auto& coefficients = *cutFilter.get<Index>().coefficients;
+
+    //untouched stages still hold the default first order filter
+    if (coefficients.getFilterOrder() == 2)
+    {
+        const auto* raw = coefficients.getRawCoefficients();
+        std::copy(raw, raw + 5, destination.stages[Index].begin());
+    }
+    else
+    {
+        destination.stages[Index] = {1.f, 0.f, 0.f, 0.f, 0.f};
+    }
+
+    destination.stageBypassed[Index] = cutFilter.isBypassed<Index>();
+}
+
+void StoreCutCoefficients(const CutFilter& cutFilter, CutCoefficients& destination)
+{
+    StoreStage<0>(cutFilter, destination);
+    StoreStage<1>(cutFilter, destination);
+    StoreStage<2>(cutFilter, destination);
+    StoreStage<3>(cutFilter, destination);
+}
+
+void LoadCutCoefficients(const CutCoefficients& source, StereoBiquadCascade& cascade, int firstStage)
+{
+    for (int i = 0; i < 4; ++i)
+    {
+        cascade.coefficients[firstStage + i] = source.stages[i];
+
+        if (!source.bypassed && !source.stageBypassed[i])
+            cascade.activeStages[cascade.numActiveStages++] = firstStage + i;
+    }
+}
+
 #pragma endregion
 
 
 //==============================================================================
+//analyzer settings ("Analyzer ...") are only read by the editor, a change never needs new coefficients
+static bool affectsFilters(const juce::String& parameterID)
+{
+    return !parameterID.startsWith("Analyzer ");
+}
+
 SampleEQAudioProcessor::SampleEQAudioProcessor()
 #ifndef JucePlugin_PreferredChannelConfigurations
     : AudioProcessor(BusesProperties()
@@ -60,10 +105,32 @@ SampleEQAudioProcessor::SampleEQAudioProcessor()
     )
 #endif
 {
+    for (auto* param : getParameters())
+    {
+        auto* rap = dynamic_cast<juce::RangedAudioParameter*>(param);
+        if (rap != nullptr && affectsFilters(rap->paramID))
+            apvts.addParameterListener(rap->paramID, this);
+    }
+
+    //control thread, designs coefficients whenever a parameter changed
+    startTimer(10);
+
+   #if SAMPLEEQ_RUN_BENCHMARKS
+    juce::Logger::writeToLog(Benchmarks::runAll());
+   #endif
 }
 
 SampleEQAudioProcessor::~SampleEQAudioProcessor()
 {
+    stopTimer();
+    cancelPendingUpdate();
+
+    for (auto* param : getParameters())
+    {
+        auto* rap = dynamic_cast<juce::RangedAudioParameter*>(param);
+        if (rap != nullptr && affectsFilters(rap->paramID))
+            apvts.removeParameterListener(rap->paramID, this);
+    }
 }
 
 //==============================================================================
@@ -138,14 +205,38 @@ void SampleEQAudioProcessor::prepareToPlay(double sampleRate, int samplesPerBloc
     spec.maximumBlockSize = samplesPerBlock;
     spec.numChannels = 1;
 
-    leftChain.prepare(spec);
-    rightChain.prepare(spec);
+    cascade.reset();
 
-    // Low High Cut Butterworth Highpass
-    UpdateFilters();
+    analyzerTaps.prepare(sampleRate, samplesPerBlock, SpectralEQ::getLatencyInSamples(Spectral_8192));
 
-    leftChannelFifo.prepare(samplesPerBlock);
-    rightChannelFifo.prepare(samplesPerBlock);
+    spectralEQ.prepare(sampleRate, getTotalNumOutputChannels());
+    spectralEQ.setCurve(getSpectralCurve());
+
+    //the audio thread isn't running, the mode is applied and reported right away
+    PublishSpectralSettings(getChainSettings(apvts));
+    spectralChanged = false;
+    spectralProcessing = spectralActive.load();
+    spectralEQ.setResolution(spectralEQResolution.load());
+    spectralEQ.reset();
+    analyzerTaps.setDifferenceLatency(spectralLatency.load());
+    cancelPendingUpdate();
+    setLatencySamples(spectralLatency.load());
+
+    {
+        const juce::ScopedLock sl(controlLock);
+        autoGain.prepare(sampleRate);
+        autoGainMagnitudes.resize(autoGain.getNumPoints());
+    }
+    preparedSampleRate = sampleRate;
+
+    // Low High Cut Butterworth Highpass, designed now so the first block is already right
+    filtersChanged = false;
+    PublishCoefficients();
+    coefficientSets.update();
+    ApplyCoefficientSet(coefficientSets.getReadBuffer());
+
+    autoGainSmoothed.reset(sampleRate, 0.05);
+    autoGainSmoothed.setCurrentAndTargetValue(coefficientSets.getReadBuffer().autoGain);
 
 
     // osc.initialise([](float x) { return std::sin(x); });
@@ -201,9 +292,22 @@ void SampleEQAudioProcessor::processBlock(juce::AudioBuffer<float>& buffer, juce
     for (auto i = totalNumInputChannels; i < totalNumOutputChannels; ++i)
         buffer.clear(i, 0, buffer.getNumSamples());
 
+    //analyzer input before the EQ touches the buffer
+    analyzerTaps.capturePre(buffer);
+
     // Low High Cut Butterworth Highpass
+    //pick up the latest complete set published by the control thread
+    if (coefficientSets.update())
+        ApplyCoefficientSet(coefficientSets.getReadBuffer());
 
-    UpdateFilters();
+    //a new mode or resolution starts from silence, its latency is reported on the message thread
+    if (spectralChanged.exchange(false))
+    {
+        spectralProcessing = spectralActive.load();
+        spectralEQ.setResolution(spectralEQResolution.load());
+        spectralEQ.reset();
+        analyzerTaps.setDifferenceLatency(spectralLatency.load());
+    }
 
     juce::dsp::AudioBlock<float> block(buffer);
 
@@ -211,19 +315,32 @@ void SampleEQAudioProcessor::processBlock(juce::AudioBuffer<float>& buffer, juce
     // juce::dsp::ProcessContextReplacing<float> stereoContext(block);
     // osc.process(stereoContext);
 
+    if (spectralProcessing)
+    {
+        spectralEQ.process(block);
+    }
+    else
+    {
+        //both channels in one pass, with the kernel picked for this CPU
+        kernels.biquadCascade(block.getChannelPointer(0), block.getChannelPointer(1),
+                              (int)block.getNumSamples(), cascade);
+    }
 
-    auto leftBlock = block.getSingleChannelBlock(0);
-    auto rightBlock = block.getSingleChannelBlock(1);
-
-    juce::dsp::ProcessContextReplacing<float> leftContext(leftBlock);
-    juce::dsp::ProcessContextReplacing<float> rightContext(rightBlock);
-
-    leftChain.process(leftContext);
-    rightChain.process(rightContext);
+    {
+        const auto numSamples = buffer.getNumSamples();
+        const auto startGain = autoGainSmoothed.getCurrentValue();
+        autoGainSmoothed.skip(numSamples);
+        const auto endGain = autoGainSmoothed.getCurrentValue();
+
+        if (startGain != 1.f || endGain != 1.f)
+        {
+            for (int channel = 0; channel < totalNumOutputChannels; ++channel)
+                buffer.applyGainRamp(channel, 0, numSamples, startGain, endGain);
+        }
+    }
 
-    //FFT Buffer
-    leftChannelFifo.update(buffer);
-    rightChannelFifo.update(buffer);
+    //FFT Buffer, commits the block started by capturePre
+    analyzerTaps.publishPost(buffer);
 
     // This is the place where you'd normally do the guts of your plugin's
     // audio processing...
@@ -269,9 +386,15 @@ void SampleEQAudioProcessor::setStateInformation(const void* data, int sizeInByt
     if (tree.isValid())
     {
         apvts.replaceState(tree);
-        UpdateFilters();
+        setSpectralCurve(getSpectralCurve());
+        filtersChanged = true;
     }
 }
+
+void SampleEQAudioProcessor::parameterChanged(const juce::String& parameterID, float newValue)
+{
+    filtersChanged = true;
+}
 #pragma region Paramater
 ChainSettings getChainSettings(juce::AudioProcessorValueTreeState& apvts)
 {
@@ -295,6 +418,11 @@ ChainSettings getChainSettings(juce::AudioProcessorValueTreeState& apvts)
     settings.highCutBypass = apvts.getRawParameterValue(highCutBypass)->load() > 0.5f;
     // settings.lowCutBypass = apvts.getRawParameterValue(lowCutBypass)->load()>0.5f;
 
+    settings.eqMode = static_cast<EQMode>(apvts.getRawParameterValue(eqMode)->load());
+    settings.spectralResolution = static_cast<SpectralResolution>(apvts.getRawParameterValue(spectralResolution)->load());
+
+    settings.autoGainMode = static_cast<AutoGainMode>(apvts.getRawParameterValue(autoGainMode)->load());
+
     return settings;
 }
 
@@ -363,6 +491,96 @@ juce::AudioProcessorValueTreeState::ParameterLayout SampleEQAudioProcessor::Crea
     layout.add(std::make_unique<juce::AudioParameterBool>(highCutBypass,highCutBypass,false));
     layout.add(std::make_unique<juce::AudioParameterBool>(analyzerByPass,analyzerByPass,false));
 
+    layout.add(std::make_unique<juce::AudioParameterChoice>(
+        eqMode,
+        eqMode,
+        juce::StringArray{"Biquad", "Spectral"},
+        EQMode_Biquad
+    ));
+
+    //latency / frequency resolution trade-off of the spectral mode
+    layout.add(std::make_unique<juce::AudioParameterChoice>(
+        spectralResolution,
+        spectralResolution,
+        juce::StringArray{"1024", "2048", "4096", "8192"},
+        Spectral_2048
+    ));
+
+    //level matched A/B, predicted from the response against a reference spectrum
+    layout.add(std::make_unique<juce::AudioParameterChoice>(
+        autoGainMode,
+        autoGainMode,
+        juce::StringArray{"Off", "Pink", "K-Weighted"},
+        AutoGain_Off
+    ));
+
+    //analyzer hop size = FFT size / overlap, display only
+    layout.add(std::make_unique<juce::AudioParameterChoice>(
+        analyzerOverlap,
+        analyzerOverlap,
+        juce::StringArray{"1x", "2x", "4x", "8x", "16x"},
+        2
+    ));
+
+    //analyzer FFT size, order 11 + index
+    layout.add(std::make_unique<juce::AudioParameterChoice>(
+        analyzerResolution,
+        analyzerResolution,
+        juce::StringArray{"2048", "4096", "8192", "16384"},
+        0
+    ));
+
+    //analyzer smoothing, ordered like SpectrumAveraging::Mode
+    layout.add(std::make_unique<juce::AudioParameterChoice>(
+        analyzerAveraging,
+        analyzerAveraging,
+        juce::StringArray{"Off", "Exponential", "Infinite", "Peak Hold"},
+        0
+    ));
+
+    //fractional-octave smoothing of the analyzer bins
+    layout.add(std::make_unique<juce::AudioParameterChoice>(
+        analyzerOctaveSmoothing,
+        analyzerOctaveSmoothing,
+        juce::StringArray{"Off", "1/1 oct", "1/3 oct", "1/6 oct", "1/12 oct", "1/24 oct"},
+        0
+    ));
+
+    //repaint cap of the response / analyzer display, "Display" = every refresh
+    layout.add(std::make_unique<juce::AudioParameterChoice>(
+        analyzerFrameRate,
+        analyzerFrameRate,
+        juce::StringArray{"15 Hz", "30 Hz", "60 Hz", "Display"},
+        2
+    ));
+
+    //extra resolution for the low end, ordered like AnalyzerMode
+    layout.add(std::make_unique<juce::AudioParameterChoice>(
+        analyzerMode,
+        analyzerMode,
+        juce::StringArray{"Full Band", "Multi-Resolution", "Zoom"},
+        AnalyzerMode_FullBand
+    ));
+
+    //region of the zoom analyzer, e.g. mains hum and its first harmonics
+    layout.add(std::make_unique<juce::AudioParameterFloat>(
+        analyzerZoomLow, analyzerZoomLow,
+        juce::NormalisableRange<float>(20.f, 20000.f, 0.1f, 0.25f)
+        , 40.0f));
+
+    layout.add(std::make_unique<juce::AudioParameterFloat>(
+        analyzerZoomHigh, analyzerZoomHigh,
+        juce::NormalisableRange<float>(20.f, 20000.f, 0.1f, 0.25f)
+        , 120.0f));
+
+    //where the analyzer listens, ordered like AnalyzerTap
+    layout.add(std::make_unique<juce::AudioParameterChoice>(
+        analyzerTap,
+        analyzerTap,
+        juce::StringArray{"Pre", "Post", "Difference"},
+        AnalyzerTap_Post
+    ));
+
     return layout;
 }
 
@@ -371,64 +589,73 @@ juce::AudioProcessorValueTreeState::ParameterLayout SampleEQAudioProcessor::Crea
 #pragma region Single Peak
 
 
-void SampleEQAudioProcessor::UpdatePeakFilter(const ChainSettings& chainSettings)
+void SampleEQAudioProcessor::UpdatePeakFilter(const ChainSettings& chainSettings, double sampleRate)
 {
-    auto peakCoefficients = makePeakFilter(chainSettings, getSampleRate());
+    auto peakCoefficients = makePeakFilter(chainSettings, sampleRate);
     
     //Single Filter
-    UpdateCoefficients(leftChain.get<ChainPosition::Peak>().coefficients, peakCoefficients);
-    UpdateCoefficients(rightChain.get<ChainPosition::Peak>().coefficients, peakCoefficients);
+    UpdateCoefficients(controlChain.get<ChainPosition::Peak>().coefficients, peakCoefficients);
 }
 
-void SampleEQAudioProcessor::UpdateHighCutFilters(const ChainSettings& chainSettings)
+void SampleEQAudioProcessor::UpdateHighCutFilters(const ChainSettings& chainSettings, double sampleRate)
 {
-    auto HighCutCoefficients = makeHighCutFilters(chainSettings, getSampleRate());
-    auto& leftHighCut = leftChain.get<ChainPosition::HighCut>();
-    auto& rightHighCut = rightChain.get<ChainPosition::HighCut>();
+    auto HighCutCoefficients = makeHighCutFilters(chainSettings, sampleRate);
+    auto& highCut = controlChain.get<ChainPosition::HighCut>();
 
-    UpdateCutFilter(leftHighCut, HighCutCoefficients, chainSettings.HighCutSlope);
-    UpdateCutFilter(rightHighCut, HighCutCoefficients, chainSettings.HighCutSlope);
+    UpdateCutFilter(highCut, HighCutCoefficients, chainSettings.HighCutSlope);
 }
 
-void SampleEQAudioProcessor::UpdateLowCutFilters(const ChainSettings& chainSettings)
+void SampleEQAudioProcessor::UpdateLowCutFilters(const ChainSettings& chainSettings, double sampleRate)
 {
-    auto LowCutCoefficients = makeLowCutFilters(chainSettings, getSampleRate());
-
-    auto& leftLowCut = leftChain.get<ChainPosition::LowCut>();
-    auto& rightLowCut = rightChain.get<ChainPosition::LowCut>();
+    auto LowCutCoefficients = makeLowCutFilters(chainSettings, sampleRate);
+    auto& lowCut = controlChain.get<ChainPosition::LowCut>();
     
-    UpdateCutFilter(leftLowCut, LowCutCoefficients, chainSettings.LowCutSlope);
-    UpdateCutFilter(rightLowCut, LowCutCoefficients, chainSettings.LowCutSlope);
+    UpdateCutFilter(lowCut, LowCutCoefficients, chainSettings.LowCutSlope);
 }
 
 
 #pragma endregion
 
+void SampleEQAudioProcessor::applyChainSettings(const ChainSettings& chainSettings)
+{
+    auto setParameter = [this](const juce::String& parameterID, float value)
+    {
+        if (auto* param = apvts.getParameter(parameterID))
+        {
+            param->beginChangeGesture();
+            param->setValueNotifyingHost(param->convertTo0to1(value));
+            param->endChangeGesture();
+        }
+    };
+
+    setParameter("LowCut Freq", chainSettings.lowCutFreq);
+    setParameter("HighCut Freq", chainSettings.highCutFreq);
+    setParameter("Peak Freq", chainSettings.peakFreq);
+    setParameter("Peak Gain", chainSettings.peakGainInDecibels);
+    setParameter("Peak Quality", chainSettings.peakQuality);
+    setParameter("LowCut Slope", (float)chainSettings.LowCutSlope);
+    setParameter("HighCut Slope", (float)chainSettings.HighCutSlope);
+    setParameter(lowCutBypass, chainSettings.lowCutBypass ? 1.f : 0.f);
+    setParameter(peakByPass, chainSettings.peakBypass ? 1.f : 0.f);
+    setParameter(highCutBypass, chainSettings.highCutBypass ? 1.f : 0.f);
+}
+
 #pragma region Low High Cut IIR
 
-void SampleEQAudioProcessor::UpdateFilters()
+void SampleEQAudioProcessor::UpdateFilters(const ChainSettings& chainSettings, double sampleRate)
 {
-    const ChainSettings& chainSettings = getChainSettings(apvts);
-
-    
-    
     //High Cut   
-    UpdateHighCutFilters(chainSettings);
+    UpdateHighCutFilters(chainSettings, sampleRate);
     // Single Filter
-    UpdatePeakFilter(chainSettings);
+    UpdatePeakFilter(chainSettings, sampleRate);
     // LowCut Butterworth Highpass
-    UpdateLowCutFilters(chainSettings);
+    UpdateLowCutFilters(chainSettings, sampleRate);
 
 
     // 设置旁通状态
-    leftChain.setBypassed<ChainPosition::LowCut>(chainSettings.lowCutBypass);
-    rightChain.setBypassed<ChainPosition::LowCut>(chainSettings.lowCutBypass);
-
-    leftChain.setBypassed<ChainPosition::Peak>(chainSettings.peakBypass);
-    rightChain.setBypassed<ChainPosition::Peak>(chainSettings.peakBypass);
-
-    leftChain.setBypassed<ChainPosition::HighCut>(chainSettings.highCutBypass);
-    rightChain.setBypassed<ChainPosition::HighCut>(chainSettings.highCutBypass);
+    controlChain.setBypassed<ChainPosition::LowCut>(chainSettings.lowCutBypass);
+    controlChain.setBypassed<ChainPosition::Peak>(chainSettings.peakBypass);
+    controlChain.setBypassed<ChainPosition::HighCut>(chainSettings.highCutBypass);
 
     // DBG("LOW = " + juce::String(chainSettings.lowCutBypass ? "true" : "false"));
     // DBG("PEAK = " + juce::String(chainSettings.peakBypass ? "true" : "false"));
@@ -436,6 +663,180 @@ void SampleEQAudioProcessor::UpdateFilters()
 
 }
 
+void SampleEQAudioProcessor::hiResTimerCallback()
+{
+    if (filtersChanged.exchange(false))
+    {
+        PublishCoefficients();
+        PublishSpectralSettings(getChainSettings(apvts));
+    }
+}
+
+void SampleEQAudioProcessor::PublishCoefficients()
+{
+    const juce::ScopedLock sl(controlLock);
+
+    const auto sampleRate = preparedSampleRate.load();
+    if (sampleRate <= 0.0)
+        return;
+
+    const auto chainSettings = getChainSettings(apvts);
+    UpdateFilters(chainSettings, sampleRate);
+
+    auto& coefficientSet = coefficientSets.getWriteBuffer();
+
+    StoreCutCoefficients(controlChain.get<ChainPosition::LowCut>(), coefficientSet.lowCut);
+    StoreCutCoefficients(controlChain.get<ChainPosition::HighCut>(), coefficientSet.highCut);
+    coefficientSet.lowCut.bypassed = chainSettings.lowCutBypass;
+    coefficientSet.highCut.bypassed = chainSettings.highCutBypass;
+
+    const auto* peak = controlChain.get<ChainPosition::Peak>().coefficients->getRawCoefficients();
+    std::copy(peak, peak + 5, coefficientSet.peak.begin());
+    coefficientSet.peakBypassed = chainSettings.peakBypass;
+
+    coefficientSet.autoGain = ComputeAutoGain(chainSettings);
+
+    coefficientSets.publish();
+}
+
+void SampleEQAudioProcessor::ApplyCoefficientSet(const FilterCoefficientSet& coefficientSet)
+{
+    //LowCut 0-3, Peak 4, HighCut 5-8, the state of skipped stages is left alone
+    cascade.numActiveStages = 0;
+
+    LoadCutCoefficients(coefficientSet.lowCut, cascade, 0);
+
+    cascade.coefficients[4] = coefficientSet.peak;
+    if (!coefficientSet.peakBypassed)
+        cascade.activeStages[cascade.numActiveStages++] = 4;
+
+    LoadCutCoefficients(coefficientSet.highCut, cascade, 5);
+
+    autoGainSmoothed.setTargetValue(coefficientSet.autoGain);
+}
+
+
+#pragma endregion
+
+#pragma region Spectral
+
+void SampleEQAudioProcessor::PublishSpectralSettings(const ChainSettings& chainSettings)
+{
+    const auto active = chainSettings.eqMode == EQMode_Spectral;
+    const auto resolution = chainSettings.spectralResolution;
+    if (active == spectralActive.load() && resolution == spectralEQResolution.load())
+        return;
+
+    //the flag last, the audio thread reads the rest once it sees it
+    spectralEQResolution = resolution;
+    spectralLatency = active ? SpectralEQ::getLatencyInSamples(resolution) : 0;
+    spectralActive = active;
+    spectralChanged = true;
+
+    triggerAsyncUpdate();
+}
+
+void SampleEQAudioProcessor::handleAsyncUpdate()
+{
+    setLatencySamples(spectralLatency.load());
+}
+
+void SampleEQAudioProcessor::setSpectralCurve(const SpectralCurve& curve)
+{
+    auto curveTree = apvts.state.getOrCreateChildWithName("SpectralCurve", nullptr);
+    curveTree.removeAllChildren(nullptr);
+
+    for (const auto& point : curve)
+    {
+        juce::ValueTree pointTree("Point");
+        pointTree.setProperty("Freq", point.frequency, nullptr);
+        pointTree.setProperty("Gain", point.gainInDecibels, nullptr);
+        curveTree.appendChild(pointTree, nullptr);
+    }
+
+    spectralEQ.setCurve(curve);
+
+    //the curve never reaches the audio thread, so its compensation is worked out here
+    std::vector<double> magnitudes;
+    for (auto freq : autoGain.getFrequencies())
+    {
+        auto gain = juce::Decibels::decibelsToGain((double)SpectralEQ::getGainForFrequency(curve, (float)freq));
+        magnitudes.push_back(gain * gain);
+    }
+
+    spectralPinkGain = autoGain.getCompensation(magnitudes, AutoGain_Pink);
+    spectralKWeightedGain = autoGain.getCompensation(magnitudes, AutoGain_KWeighted);
+    filtersChanged = true;
+}
+
+SpectralCurve SampleEQAudioProcessor::getSpectralCurve() const
+{
+    SpectralCurve curve;
+
+    auto curveTree = apvts.state.getChildWithName("SpectralCurve");
+    for (const auto& pointTree : curveTree)
+    {
+        SpectralCurvePoint point;
+        point.frequency = pointTree.getProperty("Freq", point.frequency);
+        point.gainInDecibels = pointTree.getProperty("Gain", point.gainInDecibels);
+        curve.push_back(point);
+    }
+
+    std::sort(curve.begin(), curve.end(),
+              [](const SpectralCurvePoint& a, const SpectralCurvePoint& b) { return a.frequency < b.frequency; });
+    return curve;
+}
+
+#pragma endregion
+
+#pragma region Auto Gain
+
+void multiplyCutFilterMagnitudeSquared(const CutFilter& cutFilter, const FilterResponse& response,
+                                       double* magnitudesSquared)
+{
+    if (!cutFilter.isBypassed<0>())
+        response.multiplyMagnitudeSquared(*cutFilter.get<0>().coefficients, magnitudesSquared);
+    if (!cutFilter.isBypassed<1>())
+        response.multiplyMagnitudeSquared(*cutFilter.get<1>().coefficients, magnitudesSquared);
+    if (!cutFilter.isBypassed<2>())
+        response.multiplyMagnitudeSquared(*cutFilter.get<2>().coefficients, magnitudesSquared);
+    if (!cutFilter.isBypassed<3>())
+        response.multiplyMagnitudeSquared(*cutFilter.get<3>().coefficients, magnitudesSquared);
+}
+
+void multiplyChainMagnitudeSquared(const MonoChain& chain, const FilterResponse& response,
+                                   double* magnitudesSquared)
+{
+    if (!chain.isBypassed<ChainPosition::LowCut>())
+        multiplyCutFilterMagnitudeSquared(chain.get<ChainPosition::LowCut>(), response, magnitudesSquared);
+
+    if (!chain.isBypassed<ChainPosition::Peak>())
+        response.multiplyMagnitudeSquared(*chain.get<ChainPosition::Peak>().coefficients, magnitudesSquared);
+
+    if (!chain.isBypassed<ChainPosition::HighCut>())
+        multiplyCutFilterMagnitudeSquared(chain.get<ChainPosition::HighCut>(), response, magnitudesSquared);
+}
+
+float SampleEQAudioProcessor::ComputeAutoGain(const ChainSettings& chainSettings)
+{
+    float target = 1.f;
+
+    if (chainSettings.eqMode == EQMode_Spectral)
+    {
+        if (chainSettings.autoGainMode == AutoGain_Pink)
+            target = spectralPinkGain.load();
+        else if (chainSettings.autoGainMode == AutoGain_KWeighted)
+            target = spectralKWeightedGain.load();
+    }
+    else if (chainSettings.autoGainMode != AutoGain_Off)
+    {
+        std::fill(autoGainMagnitudes.begin(), autoGainMagnitudes.end(), 1.0);
+        multiplyChainMagnitudeSquared(controlChain, autoGain.getResponse(), autoGainMagnitudes.data());
+        target = autoGain.getCompensation(autoGainMagnitudes, chainSettings.autoGainMode);
+    }
+
+    return target;
+}
 
 #pragma endregion
 
@@ -11,6 +11,11 @@
 #include <JuceHeader.h>
 
 #include "SingleChannelSampleFifo.h"
+#include "AnalyzerTapTransport.h"
+#include "SpectralEQ.h"
+#include "AutoGain.h"
+#include "TripleBuffer.h"
+#include "DspKernels.h"
 
 enum Slope
 {
@@ -20,6 +25,12 @@ enum Slope
     Slope_48,
 };
 
+enum EQMode
+{
+    EQMode_Biquad,
+    EQMode_Spectral,
+};
+
 struct ChainSettings
 {
     float peakFreq{0}, peakGainInDecibels{0}, peakQuality{1.0f};
@@ -27,6 +38,11 @@ struct ChainSettings
 
     Slope LowCutSlope{Slope::Slope_12}, HighCutSlope{Slope::Slope_12};
     bool lowCutBypass{true}, peakBypass{false}, highCutBypass{false};
+
+    EQMode eqMode{EQMode::EQMode_Biquad};
+    SpectralResolution spectralResolution{SpectralResolution::Spectral_2048};
+
+    AutoGainMode autoGainMode{AutoGainMode::AutoGain_Off};
 };
 
 
@@ -44,6 +60,23 @@ enum ChainPosition
 
 using Coefficients = Filter::CoefficientsPtr;
 
+//Plain copies of the normalised biquad coefficients (b0 b1 b2 a1 a2, see DspKernels.h), safe to hand to the audio thread
+struct CutCoefficients
+{
+    std::array<BiquadCoefficients, 4> stages{};
+    std::array<bool, 4> stageBypassed{true, true, true, true};
+    bool bypassed = false;
+};
+
+struct FilterCoefficientSet
+{
+    CutCoefficients lowCut, highCut;
+    BiquadCoefficients peak{};
+    bool peakBypassed = false;
+
+    float autoGain = 1.f;
+};
+
 ChainSettings getChainSettings(juce::AudioProcessorValueTreeState& apvts);
 
 //Single Frequency 
@@ -56,6 +89,10 @@ void Update(ChainType& Chain, const CoefficientType& coefficients);
 template <typename ChainType, typename CoefficientType>
 void UpdateCutFilter(ChainType& leftLowCut, const CoefficientType& cutCoefficients, const Slope& lowCutSlope);
 
+//Magnitude response, skips bypassed stages
+void multiplyCutFilterMagnitudeSquared(const CutFilter& cutFilter, const FilterResponse& response, double* magnitudesSquared);
+void multiplyChainMagnitudeSquared(const MonoChain& chain, const FilterResponse& response, double* magnitudesSquared);
+
 
 //Filter
 
@@ -106,8 +143,28 @@ const std::string
     highCutBypass = "HighCut Bypass",
     analyzerByPass = "Analyzer Bypass";
 
+const std::string
+    eqMode = "EQ Mode",
+    spectralResolution = "Spectral Resolution",
+    autoGainMode = "Auto Gain";
 
-class SampleEQAudioProcessor : public juce::AudioProcessor
+//every analyzer setting is named "Analyzer ...", the processor doesn't listen to them
+const std::string
+    analyzerOverlap = "Analyzer Overlap",
+    analyzerResolution = "Analyzer Resolution",
+    analyzerAveraging = "Analyzer Averaging",
+    analyzerOctaveSmoothing = "Analyzer Octave Smoothing",
+    analyzerFrameRate = "Analyzer Frame Rate",
+    analyzerMode = "Analyzer Mode",
+    analyzerZoomLow = "Analyzer Zoom Low",
+    analyzerZoomHigh = "Analyzer Zoom High",
+    analyzerTap = "Analyzer Tap";
+
+
+class SampleEQAudioProcessor : public juce::AudioProcessor,
+                               public juce::AudioProcessorValueTreeState::Listener,
+                               private juce::HighResolutionTimer,
+                               private juce::AsyncUpdater
 {
 public:
     //==============================================================================
@@ -147,6 +204,8 @@ public:
     void getStateInformation(juce::MemoryBlock& destData) override;
     void setStateInformation(const void* data, int sizeInBytes) override;
 
+    void parameterChanged(const juce::String& parameterID, float newValue) override;
+
     //Kotono
     //https://docs.juce.com/master/classAudioProcessorParameter.html
     static juce::AudioProcessorValueTreeState::ParameterLayout CreateParameterLayout();
@@ -159,22 +218,65 @@ public:
     };
 
     using BlockType = juce::AudioBuffer<float>;
-    SingleChannelSampleFifo<BlockType> leftChannelFifo{Channel::Left};
-    SingleChannelSampleFifo<BlockType> rightChannelFifo{Channel::Right};
+    AnalyzerTapTransport analyzerTaps;
+
+    //Spectral mode, breakpoints sorted by frequency and stored in the apvts state
+    void setSpectralCurve(const SpectralCurve& curve);
+    SpectralCurve getSpectralCurve() const;
+
+    //pushes settings (e.g. a Match EQ result) to the parameters, message thread
+    void applyChainSettings(const ChainSettings& chainSettings);
 
 private:
     //==============================================================================
 
 
-    MonoChain leftChain, rightChain;
+    //Audio thread only, coefficients arrive through coefficientSets
+    StereoBiquadCascade cascade;
+    const DspKernels& kernels = getDspKernels();
 
-    void UpdateFilters();
+    /*
+     Control thread: coefficients are designed into controlChain off the
+     audio thread and published as a complete FilterCoefficientSet.
+     */
+    MonoChain controlChain;
+    juce::CriticalSection controlLock;
+    TripleBuffer<FilterCoefficientSet> coefficientSets;
+    std::atomic<double> preparedSampleRate{0.0};
 
-    //Single Filter
-    void UpdatePeakFilter(const ChainSettings& chainSettings);
+    void hiResTimerCallback() override;
+    void PublishCoefficients();
+    void ApplyCoefficientSet(const FilterCoefficientSet& coefficientSet);
 
-    void UpdateHighCutFilters(const ChainSettings& chainSettings);
-    void UpdateLowCutFilters(const ChainSettings& chainSettings);
+    void UpdateFilters(const ChainSettings& chainSettings, double sampleRate);
+
+    //Single Filter
+    void UpdatePeakFilter(const ChainSettings& chainSettings, double sampleRate);
+
+    void UpdateHighCutFilters(const ChainSettings& chainSettings, double sampleRate);
+    void UpdateLowCutFilters(const ChainSettings& chainSettings, double sampleRate);
+
+    /*
+     Spectral: the control thread notices a mode / resolution change, the audio
+     thread picks it up between blocks and the message thread reports the new
+     latency, updateHostDisplay() never runs on the audio thread.
+     */
+    SpectralEQ spectralEQ;
+    std::atomic<bool> spectralActive{false}, spectralChanged{false};
+    std::atomic<SpectralResolution> spectralEQResolution{Spectral_2048};
+    std::atomic<int> spectralLatency{0};
+    bool spectralProcessing = false; //audio thread's copy of spectralActive, taken with the reset
+
+    void PublishSpectralSettings(const ChainSettings& chainSettings);
+    void handleAsyncUpdate() override;
+
+    //Auto Gain, recomputed on the control thread only when a parameter changed
+    AutoGain autoGain;
+    std::vector<double> autoGainMagnitudes;
+    juce::SmoothedValue<float, juce::ValueSmoothingTypes::Multiplicative> autoGainSmoothed{1.f};
+    std::atomic<float> spectralPinkGain{1.f}, spectralKWeightedGain{1.f};
+    std::atomic<bool> filtersChanged{true};
+    float ComputeAutoGain(const ChainSettings& chainSettings);
 
     juce::dsp::Oscillator<float> osc;
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(SampleEQAudioProcessor)
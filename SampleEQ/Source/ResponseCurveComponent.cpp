@@ -12,8 +12,7 @@
 
 ResponseCurveComponent::ResponseCurveComponent(SampleEQAudioProcessor& p) :
     audioProcessor(p),
-    leftPathProducer(audioProcessor.leftChannelFifo),
-    rightPathProducer(audioProcessor.rightChannelFifo)
+    pathProducer(audioProcessor.analyzerTaps)
 
 {
     const auto& parmas = audioProcessor.getParameters();
@@ -25,7 +24,10 @@ ResponseCurveComponent::ResponseCurveComponent(SampleEQAudioProcessor& p) :
 
 
     UpdateChain();
-    startTimerHz(60);
+    updateResponseCurve();
+
+    //the grid layer fills every pixel
+    setOpaque(true);
 }
 
 ResponseCurveComponent::~ResponseCurveComponent()
@@ -47,168 +49,199 @@ void ResponseCurveComponent::parameterGestureChanged(int parameterIndex, bool ge
 {
 }
 
-void ResponseCurveComponent::timerCallback()
+void ResponseCurveComponent::onVBlank()
 {
+    //"Display" follows the refresh rate, the others cap it
+    static constexpr double frameRates[] = {15.0, 30.0, 60.0, 0.0};
+    const auto frameRate = frameRates[juce::jlimit(0, 3,
+        (int)audioProcessor.apvts.getRawParameterValue(analyzerFrameRate)->load())];
+
+    const auto now = juce::Time::getMillisecondCounterHiRes();
+
+    //10% slack, refreshes never land exactly on the interval
+    if (frameRate > 0.0 && now - lastFrameTime < 0.9 * 1000.0 / frameRate)
+    {
+        ++repaintCounters.framesSkipped;
+        return;
+    }
+
+    bool needsRepaint = false;
+
     if(shouldShowFFTAnalysis)
     {
         auto fftBounds = getAnalysisArea().toFloat();
         auto sampleRate = audioProcessor.getSampleRate();
-        updateFFT(fftBounds, sampleRate);
+        if (updateFFT(fftBounds, sampleRate))
+        {
+            layers[Layer_Analyzer].needsRedraw = true;
+            needsRepaint = true;
+        }
     }
  
 
     //Updata
-    if (parametersChanged.compareAndSetBool(false, true))
+    if (parametersChanged.compareAndSetBool(false, true) || audioProcessor.getSampleRate() != responseSampleRate)
     {
         // Update momo chain
         UpdateChain();
-        // signal a repaint 
-        // repaint();
     }
 
-    repaint();
+    //cheap when nothing changed, the spectral curve isn't a parameter so it is checked here
+    needsRepaint = updateResponseCurve() || needsRepaint;
+
+    if (!needsRepaint)
+    {
+        ++repaintCounters.framesSkipped;
+        return;
+    }
+
+    //the labels around it live in the grid layer and don't change
+    lastFrameTime = now;
+    ++repaintCounters.framesPainted;
+    repaint(getRenderArea());
 }
 
 
 void ResponseCurveComponent::UpdateChain()
 {
     auto chainSettings = getChainSettings(audioProcessor.apvts);
-    auto peakCoefficients = makePeakFilter(chainSettings, audioProcessor.getSampleRate());
+    auto sampleRate = audioProcessor.getSampleRate();
+    const auto& last = lastChainSettings;
+    const bool sampleRateChanged = sampleRate != responseSampleRate;
 
-    monoChain.setBypassed<ChainPosition::LowCut>(chainSettings.lowCutBypass);
-    monoChain.setBypassed<ChainPosition::Peak>(chainSettings.peakBypass);
-    monoChain.setBypassed<ChainPosition::HighCut>(chainSettings.highCutBypass);
+    //a band is only rebuilt when one of its own settings moved
+    auto& lowCutBand = bandResponses[ChainPosition::LowCut];
+    auto& peakBand = bandResponses[ChainPosition::Peak];
+    auto& highCutBand = bandResponses[ChainPosition::HighCut];
 
-    UpdateCoefficients(monoChain.get<ChainPosition::Peak>().coefficients, peakCoefficients);
+    if (sampleRateChanged || chainSettings.lowCutFreq != last.lowCutFreq
+        || chainSettings.LowCutSlope != last.LowCutSlope || chainSettings.lowCutBypass != last.lowCutBypass)
+        lowCutBand.needsUpdate = true;
 
-    auto lowCutCoefficients = makeLowCutFilters(chainSettings, audioProcessor.getSampleRate());
-    auto highCutCoefficients = makeHighCutFilters(chainSettings, audioProcessor.getSampleRate());
+    if (sampleRateChanged || chainSettings.peakFreq != last.peakFreq
+        || chainSettings.peakGainInDecibels != last.peakGainInDecibels
+        || chainSettings.peakQuality != last.peakQuality || chainSettings.peakBypass != last.peakBypass)
+        peakBand.needsUpdate = true;
 
-    UpdateCutFilter(monoChain.get<LowCut>(), lowCutCoefficients, chainSettings.LowCutSlope);
-    UpdateCutFilter(monoChain.get<HighCut>(), highCutCoefficients, chainSettings.HighCutSlope);
-    //single a repaint
-}
+    if (sampleRateChanged || chainSettings.highCutFreq != last.highCutFreq
+        || chainSettings.HighCutSlope != last.HighCutSlope || chainSettings.highCutBypass != last.highCutBypass)
+        highCutBand.needsUpdate = true;
 
-void ResponseCurveComponent::updateFFT(juce::Rectangle<float> fftBounds, double sampleRate)
-{
-    leftPathProducer.process(fftBounds, sampleRate);
-    rightPathProducer.process(fftBounds, sampleRate);
-}
+    lastChainSettings = chainSettings;
+    responseSampleRate = sampleRate;
 
-void ResponseCurveComponent::paint(juce::Graphics& g)
-{
-    Component::paint(g);
-    using namespace juce;
+    //the frequency grid of filterResponse depends on the sample rate too
+    if (sampleRateChanged)
+        responseCurveNeedsUpdate = true;
 
-    paintResponseCurve(g);
+    if (sampleRate <= 0.0)
+        return;
 
-    if(shouldShowFFTAnalysis)
+    if (lowCutBand.needsUpdate)
     {
-        //Limit the path in the area 
-        auto leftChannelFFTPath = leftPathProducer.getPath();
-        auto rightChannelFFTPath = rightPathProducer.getPath();
-        leftChannelFFTPath.
-            applyTransform(AffineTransform().translation(getAnalysisArea().getX(), getAnalysisArea().getY()));
-        rightChannelFFTPath.
-            applyTransform(AffineTransform().translation(getAnalysisArea().getX(), getAnalysisArea().getY()));
-
-
-        g.setColour(Colours::blue);
-        g.strokePath(leftPathProducer.getPath(), PathStrokeType(1));
-        g.setColour(Colours::red);
-        g.strokePath(rightPathProducer.getPath(), PathStrokeType(1));
+        monoChain.setBypassed<ChainPosition::LowCut>(chainSettings.lowCutBypass);
+        auto lowCutCoefficients = makeLowCutFilters(chainSettings, sampleRate);
+        UpdateCutFilter(monoChain.get<LowCut>(), lowCutCoefficients, chainSettings.LowCutSlope);
     }
-    
-    
-    // g.setColour(Colours::red);
-    // g.drawRect(getLocalBounds());
 
-    g.setColour(Colours::orange);
-    g.drawRoundedRectangle(getRenderArea().toFloat(), 2.0f, 1.0f);
+    if (peakBand.needsUpdate)
+    {
+        monoChain.setBypassed<ChainPosition::Peak>(chainSettings.peakBypass);
+        auto peakCoefficients = makePeakFilter(chainSettings, sampleRate);
+        UpdateCoefficients(monoChain.get<ChainPosition::Peak>().coefficients, peakCoefficients);
+    }
+
+    if (highCutBand.needsUpdate)
+    {
+        monoChain.setBypassed<ChainPosition::HighCut>(chainSettings.highCutBypass);
+        auto highCutCoefficients = makeHighCutFilters(chainSettings, sampleRate);
+        UpdateCutFilter(monoChain.get<HighCut>(), highCutCoefficients, chainSettings.HighCutSlope);
+    }
+    //single a repaint
 }
 
-void ResponseCurveComponent::paintResponseCurve(juce::Graphics& g)
+bool ResponseCurveComponent::updateResponseCurve()
 {
     using namespace juce;
-    // g.fillAll(getLookAndFeel().findColour(juce::ResizableWindow::backgroundColourId));
-    g.fillAll(Colours::black);
-    g.drawImage(background, getLocalBounds().toFloat());
-
 
-    // auto responseArea = getLocalBounds();
-    //limit line
     auto responseArea = getAnalysisArea();
+    const auto W = responseArea.getWidth();
+    if (W <= 0 || responseSampleRate <= 0.0)
+        return false;
 
-    auto W = responseArea.getWidth();
-    auto H = responseArea.getHeight();
+    //new width or sample rate: every band is evaluated again on the new grid
+    if (filterResponse.getNumFrequencies() != W || responseCurveNeedsUpdate)
+    {
+        std::vector<double> frequencies((size_t)W);
+        for (int i = 0; i < W; ++i)
+            frequencies[(size_t)i] = mapToLog10(double(i) / double(W), 20.0, 20000.0);
 
-    //Get filter for chain
-    auto& lowCut = monoChain.get<ChainPosition::LowCut>();
-    auto& peak = monoChain.get<ChainPosition::Peak>();
-    auto& highCut = monoChain.get<ChainPosition::HighCut>();
+        filterResponse.setFrequencies(frequencies, responseSampleRate);
+        curveDecibels.resize((size_t)W);
 
-    auto sampleRate = audioProcessor.getSampleRate();
-    std::vector<double> mags;
-    mags.resize(W);
+        for (auto& band : bandResponses)
+            band.needsUpdate = true;
+    }
 
+    const auto spectralMode = isSpectralMode();
 
-    for (int i = 0; i < W; ++i)
+    if (spectralMode)
+    {
+        auto spectralCurve = audioProcessor.getSpectralCurve();
+        auto sameCurve = std::equal(spectralCurve.begin(), spectralCurve.end(),
+                                    lastSpectralCurve.begin(), lastSpectralCurve.end(),
+                                    [](const SpectralCurvePoint& a, const SpectralCurvePoint& b)
+                                    {
+                                        return a.frequency == b.frequency && a.gainInDecibels == b.gainInDecibels;
+                                    });
+
+        if (lastSpectralMode && sameCurve && !responseCurveNeedsUpdate)
+            return false;
+
+        const auto& frequencies = filterResponse.getFrequencies();
+        for (int i = 0; i < W; ++i)
+            curveDecibels[(size_t)i] = SpectralEQ::getGainForFrequency(spectralCurve, (float)frequencies[(size_t)i]);
+
+        lastSpectralCurve = std::move(spectralCurve);
+    }
+    else
     {
-        double mag = 1.0f;
-        auto freq = mapToLog10(double(i) / double(W), 20.0, 20000.0);
+        bool anyBandUpdated = false;
 
-        if (!monoChain.isBypassed<ChainPosition::Peak>())
+        for (int position = ChainPosition::LowCut; position <= ChainPosition::HighCut; ++position)
         {
-            mag *= peak.coefficients->getMagnitudeForFrequency(freq, sampleRate);
+            auto& band = bandResponses[position];
+            if (!band.needsUpdate)
+                continue;
+
+            band.magnitudesSquared.assign((size_t)W, 1.0);
+            auto* magnitudesSquared = band.magnitudesSquared.data();
+
+            if (position == ChainPosition::LowCut && !monoChain.isBypassed<ChainPosition::LowCut>())
+                multiplyCutFilterMagnitudeSquared(monoChain.get<ChainPosition::LowCut>(), filterResponse, magnitudesSquared);
+            else if (position == ChainPosition::Peak && !monoChain.isBypassed<ChainPosition::Peak>())
+                filterResponse.multiplyMagnitudeSquared(*monoChain.get<ChainPosition::Peak>().coefficients, magnitudesSquared);
+            else if (position == ChainPosition::HighCut && !monoChain.isBypassed<ChainPosition::HighCut>())
+                multiplyCutFilterMagnitudeSquared(monoChain.get<ChainPosition::HighCut>(), filterResponse, magnitudesSquared);
+
+            band.needsUpdate = false;
+            anyBandUpdated = true;
         }
 
-        if (!monoChain.isBypassed<ChainPosition::LowCut>())
-        {
-             
-            if (!lowCut.isBypassed<0>())
-            {
-                mag *= lowCut.get<0>().coefficients->getMagnitudeForFrequency(freq, sampleRate);
-            }
-            if (!lowCut.isBypassed<1>())
-            {
-                mag *= lowCut.get<1>().coefficients->getMagnitudeForFrequency(freq, sampleRate);
-            }
-            if (!lowCut.isBypassed<2>())
-            {
-                mag *= lowCut.get<2>().coefficients->getMagnitudeForFrequency(freq, sampleRate);
-            }
-            if (!lowCut.isBypassed<3>())
-            {
-                mag *= lowCut.get<3>().coefficients->getMagnitudeForFrequency(freq, sampleRate);
-            }
-        }
-       
-        if (!monoChain.isBypassed<ChainPosition::HighCut>())
-        {
-            if (!highCut.isBypassed<0>())
-            {
-                mag *= highCut.get<0>().coefficients->getMagnitudeForFrequency(freq, sampleRate);
-            }
-            if (!highCut.isBypassed<1>())
-            {
-                mag *= highCut.get<1>().coefficients->getMagnitudeForFrequency(freq, sampleRate);
-            }
-            if (!highCut.isBypassed<2>())
-            {
-                mag *= highCut.get<2>().coefficients->getMagnitudeForFrequency(freq, sampleRate);
-            }
-            if (!highCut.isBypassed<3>())
-            {
-                mag *= highCut.get<3>().coefficients->getMagnitudeForFrequency(freq, sampleRate);
-            }
-        }
-        
+        if (!lastSpectralMode && !anyBandUpdated && !responseCurveNeedsUpdate)
+            return false;
+
+        const auto& lowCut = bandResponses[ChainPosition::LowCut].magnitudesSquared;
+        const auto& peak = bandResponses[ChainPosition::Peak].magnitudesSquared;
+        const auto& highCut = bandResponses[ChainPosition::HighCut].magnitudesSquared;
 
-        mags[i] = Decibels::gainToDecibels(mag);
+        for (int i = 0; i < W; ++i)
+            curveDecibels[(size_t)i] = Decibels::gainToDecibels(std::sqrt(lowCut[(size_t)i] * peak[(size_t)i] * highCut[(size_t)i]));
     }
 
+    lastSpectralMode = spectralMode;
+    responseCurveNeedsUpdate = false;
 
-    Path responseCurve;
     const double outputMin = responseArea.getBottom();
     const double outputMax = responseArea.getY();
     auto map = [outputMin,outputMax](double input)
@@ -216,13 +249,172 @@ void ResponseCurveComponent::paintResponseCurve(juce::Graphics& g)
         return jmap(input, -24.0, 24.0, outputMin, outputMax);
     };
 
-    responseCurve.startNewSubPath(responseArea.getX(), map(mags.front()));
+    responseCurve.clear();
+    responseCurve.preallocateSpace(3 * W);
+    responseCurve.startNewSubPath(responseArea.getX(), map(curveDecibels.front()));
+
+    for (int i = 1; i < W; ++i)
+    {
+        responseCurve.lineTo(responseArea.getX() + i, map(curveDecibels[(size_t)i]));
+    }
+
+    layers[Layer_ResponseCurve].needsRedraw = true;
+    return true;
+}
+
+bool ResponseCurveComponent::updateFFT(juce::Rectangle<float> fftBounds, double sampleRate)
+{
+    //the analysis itself runs on the AnalyzerWorker thread
+    PathProducer::AnalysisSettings settings;
+    settings.fftBounds = fftBounds;
+    settings.sampleRate = sampleRate;
+    settings.overlap = 1 << (int)audioProcessor.apvts.getRawParameterValue(analyzerOverlap)->load();
+    settings.order = static_cast<FFTOrder>(FFTOrder::order2048
+        + (int)audioProcessor.apvts.getRawParameterValue(analyzerResolution)->load());
+    settings.averaging = static_cast<SpectrumAveraging::Mode>(
+        (int)audioProcessor.apvts.getRawParameterValue(analyzerAveraging)->load());
+
+    static constexpr int bandsPerOctave[] = {0, 1, 3, 6, 12, 24};
+    settings.smoothingBandsPerOctave = bandsPerOctave[juce::jlimit(0, 5,
+        (int)audioProcessor.apvts.getRawParameterValue(analyzerOctaveSmoothing)->load())];
+    settings.mode = static_cast<AnalyzerMode>(
+        (int)audioProcessor.apvts.getRawParameterValue(analyzerMode)->load());
+
+    //the region works either way round
+    const auto zoomLow = audioProcessor.apvts.getRawParameterValue(analyzerZoomLow)->load();
+    const auto zoomHigh = audioProcessor.apvts.getRawParameterValue(analyzerZoomHigh)->load();
+    settings.zoomLowFrequency = juce::jmin(zoomLow, zoomHigh);
+    settings.zoomHighFrequency = juce::jmax(zoomLow, zoomHigh);
+    settings.tap = static_cast<AnalyzerTap>(
+        (int)audioProcessor.apvts.getRawParameterValue(analyzerTap)->load());
+    pathProducer.setAnalysisSettings(settings);
+    return pathProducer.pullPaths();
+}
+
+void ResponseCurveComponent::paint(juce::Graphics& g)
+{
+    using namespace juce;
 
-    for (size_t i = 1; i < mags.size(); ++i)
+    //layers are kept at the physical resolution, a new scale (e.g. another display) redraws them all
+    const auto scale = g.getInternalContext().getPhysicalPixelScaleFactor();
+    if (scale != layerScale)
     {
-        responseCurve.lineTo(responseArea.getX() + i, map(mags[i]));
+        layerScale = scale;
+        invalidateLayers();
     }
 
+    renderLayer(Layer_Grid, [this](Graphics& lg) { paintGrid(lg); });
+    renderLayer(Layer_ResponseCurve, [this](Graphics& lg) { paintResponseCurve(lg); });
+
+    if (shouldShowFFTAnalysis)
+        renderLayer(Layer_Analyzer, [this](Graphics& lg) { paintAnalyzer(lg); });
+
+    const auto bounds = getLocalBounds().toFloat();
+    g.drawImage(layers[Layer_Grid].image, bounds);
+
+    if (shouldShowFFTAnalysis)
+        g.drawImage(layers[Layer_Analyzer].image, bounds);
+
+    //the curve stays on top of the analyzer
+    g.drawImage(layers[Layer_ResponseCurve].image, bounds);
+}
+
+template <typename PaintFunction>
+void ResponseCurveComponent::renderLayer(Layer layer, PaintFunction&& paintLayer)
+{
+    auto& cached = layers[layer];
+    if (!cached.needsRedraw)
+        return;
+
+    const auto start = juce::Time::getMillisecondCounterHiRes();
+
+    const auto width = juce::roundToInt((float)getWidth() * layerScale);
+    const auto height = juce::roundToInt((float)getHeight() * layerScale);
+
+    //the grid covers everything, the other layers are drawn over it
+    const auto format = layer == Layer_Grid ? juce::Image::RGB : juce::Image::ARGB;
+
+    if (cached.image.getWidth() != width || cached.image.getHeight() != height
+        || cached.image.getFormat() != format)
+        cached.image = juce::Image(format, juce::jmax(1, width), juce::jmax(1, height), true);
+    else
+        cached.image.clear(cached.image.getBounds());
+
+    {
+        juce::Graphics g(cached.image);
+        g.addTransform(juce::AffineTransform::scale(layerScale));
+        paintLayer(g);
+    }
+
+    cached.needsRedraw = false;
+
+    auto& timing = cached.timing;
+    timing.lastMilliseconds = juce::Time::getMillisecondCounterHiRes() - start;
+    timing.totalMilliseconds += timing.lastMilliseconds;
+    ++timing.numRenders;
+}
+
+void ResponseCurveComponent::invalidateLayers()
+{
+    for (auto& layer : layers)
+        layer.needsRedraw = true;
+}
+
+ResponseCurveComponent::LayerTiming ResponseCurveComponent::getLayerTiming(Layer layer) const
+{
+    return layers[layer].timing;
+}
+
+size_t ResponseCurveComponent::getLayerMemoryUsage() const
+{
+    size_t bytes = 0;
+
+    for (const auto& layer : layers)
+        if (layer.image.isValid())
+            bytes += (size_t)layer.image.getWidth() * (size_t)layer.image.getHeight() * sizeof(juce::PixelARGB);
+
+    return bytes;
+}
+
+juce::String ResponseCurveComponent::getTooltip()
+{
+    auto describe = [](size_t bytes) { return juce::File::descriptionOfSizeInBytes((juce::int64)bytes); };
+
+    juce::String tooltip;
+    tooltip << "Analyzer memory: tap ring " << describe(audioProcessor.analyzerTaps.getMemoryUsage())
+        << ", FFT " << describe(pathProducer.getMemoryUsage())
+        << ", layers " << describe(getLayerMemoryUsage());
+
+    //frames the analyzer coalesced or the display never showed, and repaints the frame rate cap saved
+    const auto frames = pathProducer.getFrameCounters();
+    tooltip << "\nAnalyzer frames: " << (juce::int64)frames.framesComputed << " computed, "
+        << (juce::int64)frames.framesSkipped << " skipped, " << (juce::int64)frames.framesDisplayed << " displayed";
+    tooltip << "\nRepaints: " << (juce::int64)repaintCounters.framesPainted << " painted, "
+        << (juce::int64)repaintCounters.framesSkipped << " skipped";
+
+    const auto timing = getLayerTiming(Layer_Analyzer);
+    if (timing.numRenders > 0)
+        tooltip << "\nAnalyzer layer: " << juce::String(timing.lastMilliseconds, 2) << " ms last, "
+            << juce::String(timing.totalMilliseconds / (double)timing.numRenders, 2) << " ms average";
+
+    return tooltip;
+}
+
+void ResponseCurveComponent::paintAnalyzer(juce::Graphics& g)
+{
+    using namespace juce;
+
+    g.setColour(Colours::blue);
+    g.strokePath(pathProducer.getPath(Channel::Left), PathStrokeType(1));
+    g.setColour(Colours::red);
+    g.strokePath(pathProducer.getPath(Channel::Right), PathStrokeType(1));
+}
+
+void ResponseCurveComponent::paintResponseCurve(juce::Graphics& g)
+{
+    using namespace juce;
+
+    //built by updateResponseCurve() when a band or the size changes
     g.setColour(Colours::white);
     g.strokePath(responseCurve, PathStrokeType(2.0f));
 }
@@ -230,9 +422,18 @@ void ResponseCurveComponent::paintResponseCurve(juce::Graphics& g)
 void ResponseCurveComponent::resized()
 {
     Component::resized();
+
+    responseCurveNeedsUpdate = true;
+    updateResponseCurve();
+
+    invalidateLayers();
+}
+
+void ResponseCurveComponent::paintGrid(juce::Graphics& g)
+{
     using namespace juce;
-    background = Image(Image::PixelFormat::RGB, getWidth(), getHeight(), true);
-    Graphics g(background);
+    // g.fillAll(getLookAndFeel().findColour(juce::ResizableWindow::backgroundColourId));
+    g.fillAll(Colours::black);
 
     Array<float> freqs{20, /*30, 40,*/ 50, 100, 200, /*300, 400,*/ 500, 1000, 2000, /*4000, */5000, 10000, 20000};
 
@@ -304,43 +505,117 @@ void ResponseCurveComponent::resized()
         r.setY(1);
 
         g.drawFittedText(str, r, juce::Justification::centred, 1);
+    }
 
+    //gain, once per line rather than once per frequency label
+    for (auto gDb : gains)
+    {
+        auto y = jmap(gDb, -24.0f, 24.0f, float(bottom), float(top));
 
-        //gain
-        for (auto gDb : gains)
-        {
-            auto y = jmap(gDb, -24.0f, 24.0f, float(bottom), float(top));
+        String str;
+        if (gDb > 0)
+            str << "+";
+        str << gDb;
 
-            String str;
-            if (gDb > 0)
-                str << "+";
-            str << gDb;
+        //font right
+        auto textWidth = g.getCurrentFont().getStringWidth(str);
 
-            //font right
-            auto textWidth = g.getCurrentFont().getStringWidth(str);
+        juce::Rectangle<int> r;
 
-            juce::Rectangle<int> r;
+        float widthScale = 1.25f; // 宽度为文本的1.5倍
+        r.setSize(textWidth * widthScale, fontHeight);
+        r.setX(getWidth() - r.getWidth());
+        r.setCentre(r.getCentre().x, y);
 
-            float widthScale = 1.25f; // 宽度为文本的1.5倍
-            r.setSize(textWidth * widthScale, fontHeight);
-            r.setX(getWidth() - r.getWidth());
-            r.setCentre(r.getCentre().x, y);
+        g.setColour(gDb == 0.f ? Colour(0u, 172u, 1u) : Colours::darkgrey);
+        g.drawFittedText(str, r, juce::Justification::centred, 1);
 
-            g.setColour(gDb == 0.f ? Colour(0u, 172u, 1u) : Colours::darkgrey);
-            g.drawFittedText(str, r, juce::Justification::centred, 1);
+        //Font left
+        str.clear();
+        str << (gDb - 24.0f);
+        r.setX(1);
+        textWidth = g.getCurrentFont().getStringWidth(str);
+        r.setSize(textWidth, fontHeight);
+        g.drawFittedText(str, r, juce::Justification::centred, 1);
+    }
 
-            //Font left
-            str.clear();
-            str << (gDb - 24.0f);
-            r.setX(1);
-            textWidth = g.getCurrentFont().getStringWidth(str);
-            r.setSize(textWidth, fontHeight);
-            g.drawFittedText(str, r, juce::Justification::centred, 1);
-        }
+    // g.setColour(Colours::red);
+    // g.drawRect(getLocalBounds());
+
+    g.setColour(Colours::orange);
+    g.drawRoundedRectangle(getRenderArea().toFloat(), 2.0f, 1.0f);
+}
+
+
+
+bool ResponseCurveComponent::isSpectralMode() const
+{
+    return audioProcessor.apvts.getRawParameterValue(eqMode)->load() == EQMode_Spectral;
+}
+
+SpectralCurvePoint ResponseCurveComponent::getCurvePointAt(juce::Point<float> position)
+{
+    using namespace juce;
+    auto area = getAnalysisArea().toFloat();
+
+    auto normX = jlimit(0.f, 1.f, (position.x - area.getX()) / area.getWidth());
+
+    SpectralCurvePoint point;
+    point.frequency = mapToLog10(normX, 20.f, 20000.f);
+    point.gainInDecibels = jlimit(-24.f, 24.f, jmap(position.y, area.getBottom(), area.getY(), -24.f, 24.f));
+    return point;
+}
+
+void ResponseCurveComponent::drawCurveSegment(SpectralCurvePoint from, SpectralCurvePoint to)
+{
+    //freehand: whatever was under the stroke is replaced by it
+    auto curve = audioProcessor.getSpectralCurve();
+    auto low = juce::jmin(from.frequency, to.frequency);
+    auto high = juce::jmax(from.frequency, to.frequency);
+
+    curve.erase(std::remove_if(curve.begin(), curve.end(), [low, high](const SpectralCurvePoint& p)
+    {
+        return p.frequency >= low && p.frequency <= high;
+    }), curve.end());
+
+    for (const auto& point : {from, to})
+    {
+        auto insertPos = std::lower_bound(curve.begin(), curve.end(), point.frequency,
+                                          [](const SpectralCurvePoint& p, float f) { return p.frequency < f; });
+        if (insertPos == curve.end() || insertPos->frequency != point.frequency)
+            curve.insert(insertPos, point);
     }
+
+    audioProcessor.setSpectralCurve(curve);
+    updateResponseCurve();
+    repaint();
 }
 
+void ResponseCurveComponent::mouseDown(const juce::MouseEvent& event)
+{
+    if (!isSpectralMode())
+        return;
+
+    lastDrawnPoint = getCurvePointAt(event.position);
+    drawCurveSegment(lastDrawnPoint, lastDrawnPoint);
+}
+
+void ResponseCurveComponent::mouseDrag(const juce::MouseEvent& event)
+{
+    if (!isSpectralMode())
+        return;
 
+    auto point = getCurvePointAt(event.position);
+    drawCurveSegment(lastDrawnPoint, point);
+    lastDrawnPoint = point;
+}
+
+void ResponseCurveComponent::mouseDoubleClick(const juce::MouseEvent& event)
+{
+    //back to flat
+    if (isSpectralMode())
+        audioProcessor.setSpectralCurve({});
+}
 
 juce::Rectangle<int> ResponseCurveComponent::getRenderArea()
 {
@@ -11,13 +11,14 @@
 #pragma once
 #include <JuceHeader.h>
 
+#include "FilterResponse.h"
 #include "PathProducer.h"
 #include "PluginProcessor.h"
 #include "RotarySliderWithLabels.h"
 
 struct ResponseCurveComponent : juce::Component,
                                 juce::AudioProcessorParameter::Listener,
-                                juce::Timer
+                                juce::TooltipClient
 {
     ResponseCurveComponent(SampleEQAudioProcessor&);
     ~ResponseCurveComponent() override;
@@ -26,22 +27,65 @@ struct ResponseCurveComponent : juce::Component,
     void parameterValueChanged(int parameterIndex, float newValue) override;
     void parameterGestureChanged(int parameterIndex, bool gestureIsStarting) override;
 
-    void timerCallback() override;
+    //once per display refresh, repaints the render area only when something changed
+    void onVBlank();
 
-    void updateFFT(juce::Rectangle<float> fftBounds, double sampleRate);
+    bool updateFFT(juce::Rectangle<float> fftBounds, double sampleRate);
 
     void paint(juce::Graphics&) override;
-    void paintResponseCurve(juce::Graphics&);
 
     void resized() override;
 
+    //Spectral mode curve drawing
+    void mouseDown(const juce::MouseEvent& event) override;
+    void mouseDrag(const juce::MouseEvent& event) override;
+    void mouseDoubleClick(const juce::MouseEvent& event) override;
+
     bool shouldShowFFTAnalysis = true;
 
     void toggleAnalysisEnableemet(bool enabled)
     {
         shouldShowFFTAnalysis = enabled;
+        pathProducer.setEnabled(enabled);
+        layers[Layer_Analyzer].needsRedraw = true;
+        repaint(getRenderArea());
     }
 
+    struct RepaintCounters
+    {
+        juce::uint64 framesPainted = 0;
+        juce::uint64 framesSkipped = 0; //display refreshes with nothing new or over the frame rate cap
+    };
+
+    RepaintCounters getRepaintCounters() const { return repaintCounters; }
+
+    //cached render layers, drawn bottom to top: grid, analyzer, response curve
+    enum Layer
+    {
+        Layer_Grid, //grid lines and labels, size / scale changes only
+        Layer_ResponseCurve, //new curve
+        Layer_Analyzer, //new analyzer paths
+        numLayers
+    };
+
+    struct LayerTiming
+    {
+        double lastMilliseconds = 0.0;
+        double totalMilliseconds = 0.0;
+        juce::uint64 numRenders = 0;
+    };
+
+    LayerTiming getLayerTiming(Layer layer) const;
+
+    //bytes held by the layer images
+    size_t getLayerMemoryUsage() const;
+
+    //what the analyzer holds in memory, read when the tooltip shows
+    juce::String getTooltip() override;
+
+    //the spectrogram reads the same analyzer frames
+    PathProducer& getPathProducer() { return pathProducer; }
+
 private:
     SampleEQAudioProcessor& audioProcessor;
     juce::Atomic<bool> parametersChanged{false};
@@ -49,9 +93,65 @@ private:
     MonoChain monoChain;
     void UpdateChain();
 
-    juce::Image background;
+    /*
+     Magnitude responses cached at the current width, one array per band
+     (indexed by ChainPosition). A parameter change only re-evaluates the band
+     it belongs to, the combined curve is kept as a ready path for paint().
+     */
+    struct BandResponse
+    {
+        std::vector<double> magnitudesSquared;
+        bool needsUpdate = true;
+    };
+
+    bool updateResponseCurve();
+
+    FilterResponse filterResponse;
+    BandResponse bandResponses[3];
+    std::vector<double> curveDecibels;
+    juce::Path responseCurve;
+
+    ChainSettings lastChainSettings;
+    double responseSampleRate = 0.0;
+    SpectralCurve lastSpectralCurve;
+    bool lastSpectralMode = false;
+    bool responseCurveNeedsUpdate = true;
+
+    /*
+     Each layer is an image at the physical pixel scale, so HiDPI displays get
+     sharp lines instead of an upscaled logical-size image. paint() only blits
+     them; a layer is redrawn when its own inputs changed.
+     */
+    struct RenderLayer
+    {
+        juce::Image image;
+        bool needsRedraw = true;
+        LayerTiming timing;
+    };
+
+    RenderLayer layers[numLayers];
+    float layerScale = 0.f;
+
+    template <typename PaintFunction>
+    void renderLayer(Layer layer, PaintFunction&& paintLayer);
+    void invalidateLayers();
+
+    void paintGrid(juce::Graphics&);
+    void paintResponseCurve(juce::Graphics&);
+    void paintAnalyzer(juce::Graphics&);
+
     juce::Rectangle<int> getRenderArea();
     juce::Rectangle<int> getAnalysisArea();
 
-    PathProducer leftPathProducer, rightPathProducer;
+    bool isSpectralMode() const;
+    SpectralCurvePoint getCurvePointAt(juce::Point<float> position);
+    void drawCurveSegment(SpectralCurvePoint from, SpectralCurvePoint to);
+    SpectralCurvePoint lastDrawnPoint;
+
+    PathProducer pathProducer;
+
+    double lastFrameTime = 0.0;
+    RepaintCounters repaintCounters;
+
+    juce::VBlankAttachment vBlankAttachment{this, [this] { onVBlank(); }};
 };
@@ -11,6 +11,10 @@
 #pragma once
 #include <JuceHeader.h>
 
+#include "AnalyzerWorker.h"
+#include "DspKernels.h"
+#include "FFTEngine.h"
+
 
 enum Channel
 {
@@ -23,6 +27,9 @@ enum Channel
 template <typename T>
 struct Fifo
 {
+    //slots are allocated here, size the ring for the rates it has to bridge
+    explicit Fifo(int capacity = defaultCapacity) : buffers((size_t)capacity), fifo(capacity) {}
+
     void prepare(int numChannels, int numSamples)
     {
         static_assert(std::is_same_v<T, juce::AudioBuffer<float>>,
@@ -50,12 +57,38 @@ struct Fifo
         }
     }
 
+    /*
+     Zero-copy access: the producer fills a preallocated slot in place and
+     commits it, the consumer reads (or swaps out) the oldest slot in place and
+     releases it. One acquire per side at a time.
+     */
+    //producer, nullptr when the ring is full
+    T* acquireWrite()
+    {
+        int start1, size1, start2, size2;
+        fifo.prepareToWrite(1, start1, size1, start2, size2);
+        return size1 > 0 ? &buffers[(size_t)start1] : nullptr;
+    }
+
+    void commitWrite() { fifo.finishedWrite(1); }
+
+    //consumer, nullptr when nothing has been committed
+    T* acquireRead()
+    {
+        int start1, size1, start2, size2;
+        fifo.prepareToRead(1, start1, size1, start2, size2);
+        return size1 > 0 ? &buffers[(size_t)start1] : nullptr;
+    }
+
+    void releaseRead() { fifo.finishedRead(1); }
+
+    //copying versions of the above
     bool push(const T& t)
     {
-        auto write = fifo.write(1);
-        if (write.blockSize1 > 0)
+        if (auto* slot = acquireWrite())
         {
-            buffers[write.startIndex1] = t;
+            *slot = t;
+            commitWrite();
             return true;
         }
 
@@ -64,10 +97,10 @@ struct Fifo
 
     bool pull(T& t)
     {
-        auto read = fifo.read(1);
-        if (read.blockSize1 > 0)
+        if (auto* slot = acquireRead())
         {
-            t = buffers[read.startIndex1];
+            t = *slot;
+            releaseRead();
             return true;
         }
 
@@ -79,12 +112,32 @@ struct Fifo
         return fifo.getNumReady();
     }
 
+    int getCapacity() const { return (int)buffers.size(); }
+
+    static constexpr int defaultCapacity = 30;
+
 private:
-    static constexpr int Capacity = 30;
-    std::array<T, Capacity> buffers;
-    juce::AbstractFifo fifo{Capacity};
+    std::vector<T> buffers;
+    juce::AbstractFifo fifo;
 };
 
+/*
+ Ring sizes of the analyzer, from the rates they bridge: the analyzer thread
+ makes at most one frame per pass, the displays pick up at minimumDisplayRate
+ or faster. Anything beyond that would only ever hold frames nobody shows.
+ */
+namespace AnalyzerCapacity
+{
+    constexpr int minimumDisplayRate = 15;
+    constexpr int passesPerSecond = 1000 / AnalyzerWorker::intervalMilliseconds;
+
+    //produced and consumed in the same pass
+    constexpr int fftFrames = 2;
+
+    //paths and spectrogram columns, read by the message thread
+    constexpr int displayFrames = passesPerSecond / minimumDisplayRate + 2;
+}
+
 
 template <typename BlockType>
 struct SingleChannelSampleFifo
@@ -100,10 +153,33 @@ struct SingleChannelSampleFifo
         jassert(buffer.getNumChannels() > channelToUse);
         auto* channelPtr = buffer.getReadPointer(channelToUse);
 
+        const auto numSamples = buffer.getNumSamples();
+        const auto capacity = size.get();
 
-        for (int i = 0; i < buffer.getNumSamples(); ++i)
+        //contiguous spans written straight into the ring slot, the boundary is checked once per span
+        for (int numCopied = 0; numCopied < numSamples;)
         {
-            pushNextSampleIntoFifo(channelPtr[i]);
+            if (fifoIndex == 0)
+            {
+                //ring full: this buffer's worth of samples is dropped into overflowBuffer
+                writeSlot = audioBufferFifo.acquireWrite();
+                if (writeSlot == nullptr)
+                    writeSlot = &overflowBuffer;
+            }
+
+            const auto span = juce::jmin(capacity - fifoIndex, numSamples - numCopied);
+            juce::FloatVectorOperations::copy(writeSlot->getWritePointer(0, fifoIndex), channelPtr + numCopied, span);
+
+            fifoIndex += span;
+            numCopied += span;
+
+            if (fifoIndex == capacity)
+            {
+                if (writeSlot != &overflowBuffer)
+                    audioBufferFifo.commitWrite();
+
+                fifoIndex = 0;
+            }
         }
     }
 
@@ -112,13 +188,14 @@ struct SingleChannelSampleFifo
         prepared.set(false);
         size.set(bufferSize);
 
-        bufferToFill.setSize(1, //channel
-                             bufferSize, //num samples
-                             false, //keepExistingContent
-                             true, //clear extra space
-                             true); //avoid reallocating
+        overflowBuffer.setSize(1, //channel
+                               bufferSize, //num samples
+                               false, //keepExistingContent
+                               true, //clear extra space
+                               true); //avoid reallocating
         audioBufferFifo.prepare(1, bufferSize);
         fifoIndex = 0;
+        writeSlot = nullptr;
         prepared.set(true);
     }
 
@@ -127,39 +204,133 @@ struct SingleChannelSampleFifo
     bool isPrepared() const { return prepared.get(); }
     int getSize() const { return size.get(); }
     //==============================================================================
-    bool getAudioBuffer(BlockType& buf) { return audioBufferFifo.pull(buf); }
+    //oldest complete buffer, read in place then release it; nullptr when none is ready
+    const BlockType* acquireAudioBuffer() { return audioBufferFifo.acquireRead(); }
+    void releaseAudioBuffer() { audioBufferFifo.releaseRead(); }
 
 private:
     Channel channelToUse;
     int fifoIndex = 0;
     Fifo<BlockType> audioBufferFifo;
-    BlockType bufferToFill;
+    BlockType* writeSlot = nullptr;
+    BlockType overflowBuffer;
     juce::Atomic<bool> prepared = false;
     juce::Atomic<int> size = 0;
+};
+
 
-    void pushNextSampleIntoFifo(float sample)
+enum FFTOrder
+{
+    order512 = 9, //zoom only, see ZoomDownmixer
+    order1024 = 10,
+    order2048 = 11,
+    order4096 = 12,
+    order8192 = 13,
+    order16384 = 14
+};
+
+//what the analyzer transforms, ordered like the "Analyzer Mode" choices
+enum AnalyzerMode
+{
+    AnalyzerMode_FullBand, //one FFT over the whole band
+    AnalyzerMode_MultiResolution, //a second FFT of the same size on the input decimated by 4, for the low end
+    AnalyzerMode_Zoom, //a small complex FFT of one region, mixed down and decimated, see ZoomDownmixer
+};
+
+//per-bin smoothing of the analyzer, done in the same pass as the dB conversion
+struct SpectrumAveraging
+{
+    enum Mode
     {
-        if (fifoIndex == bufferToFill.getNumSamples())
+        Off,
+        Exponential,
+        Infinite,
+        PeakHold
+    };
+
+    Mode mode = Off;
+    float weight = 1.f; //Exponential: share of the newest frame
+    float decayInDecibels = 0.f; //PeakHold: fall since the previous frame
+};
+
+/*
+ Fractional-octave smoothing of one channel's magnitudes: every bin becomes
+ the RMS of the bins within 1/bandsPerOctave of an octave around it.
+
+ The power is summed once into a prefix array, each output bin is then one
+ difference of two prefix entries whatever the band width. The sums are in
+ double, a loud low end would otherwise swallow the quiet top octaves.
+ Bands are in bins relative to the bin itself, so the edge tables only
+ depend on the FFT size and the fraction, not on the sample rate.
+ */
+struct FractionalOctaveSmoothing
+{
+    //0 = off
+    void prepare(int numBinsToUse, int bandsPerOctaveToUse)
+    {
+        if (numBinsToUse == numBins && bandsPerOctaveToUse == bandsPerOctave)
+            return;
+
+        numBins = numBinsToUse;
+        bandsPerOctave = bandsPerOctaveToUse;
+
+        if (bandsPerOctave <= 0)
         {
-            // return;
-            auto ok = audioBufferFifo.push(bufferToFill);
+            bandStart.clear();
+            bandEnd.clear();
+            powerSums.clear();
+            return;
+        }
 
-            juce::ignoreUnused(ok);
+        bandStart.resize((size_t)numBins);
+        bandEnd.resize((size_t)numBins);
+        powerSums.resize((size_t)numBins + 1);
 
-            fifoIndex = 0;
+        //bins whose centre lies within half a band below and above bin k
+        const auto halfBand = std::pow(2.0, 0.5 / bandsPerOctave);
+
+        for (int k = 0; k < numBins; ++k)
+        {
+            bandStart[(size_t)k] = juce::jlimit(0, k, (int)std::ceil(k / halfBand - 1.0e-9));
+            bandEnd[(size_t)k] = juce::jlimit(k + 1, numBins, (int)std::floor(k * halfBand + 1.0e-9) + 1);
         }
+    }
+
+    bool isActive() const { return bandsPerOctave > 0; }
 
-        bufferToFill.setSample(0, fifoIndex, sample);
-        ++fifoIndex;
+    size_t getMemoryUsage() const
+    {
+        return (bandStart.capacity() + bandEnd.capacity()) * sizeof(int) + powerSums.capacity() * sizeof(double);
     }
-};
 
+    //in place, non-finite magnitudes count as silence
+    void process(float* magnitudes)
+    {
+        jassert(isActive());
 
-enum FFTOrder
-{
-    order2048 = 11,
-    order4096 = 12,
-    order8192 = 13
+        double sum = 0.0;
+        powerSums[0] = 0.0;
+
+        for (int k = 0; k < numBins; ++k)
+        {
+            const auto magnitude = (double)magnitudes[k];
+            sum += std::isfinite(magnitude) ? magnitude * magnitude : 0.0;
+            powerSums[(size_t)k + 1] = sum;
+        }
+
+        for (int k = 0; k < numBins; ++k)
+        {
+            const auto start = bandStart[(size_t)k], end = bandEnd[(size_t)k];
+            const auto power = (powerSums[(size_t)end] - powerSums[(size_t)start]) / (end - start);
+            magnitudes[k] = (float)std::sqrt(juce::jmax(0.0, power));
+        }
+    }
+
+private:
+    int numBins = 0;
+    int bandsPerOctave = 0;
+    std::vector<int> bandStart, bandEnd; //[start, end) per bin
+    std::vector<double> powerSums; //powerSums[k] = sum of the power of bins below k
 };
 
 template <typename BlockType>
@@ -172,75 +343,332 @@ struct FFTDataGenerator
     {
         const auto fftSize = getFFTSize();
 
-        fftData.assign(fftData.size(), 0);
-        auto* readIndex = audioData.getReadPointer(0);
-        std::copy(readIndex, readIndex + fftSize, fftData.begin());
+        //nobody would read this frame, skip the transform
+        auto* slot = fftDataFifo.acquireWrite();
+        if (slot == nullptr)
+            return;
 
-        // first apply a windowing function to our data
-        window->multiplyWithWindowingTable(fftData.data(), fftSize); // [1]
+        auto& fftData = *slot;
 
-        // then render our FFT data..
-        forwardFFT->performFrequencyOnlyForwardTransform(fftData.data()); // [2]
+        // windowed on the way into the FFT
+        fftEngine->transform(audioData.getReadPointer(0), nullptr, windowTable.data()); // [1] [2]
 
         int numBins = (int)fftSize / 2;
 
-        //normalize the fft values.
-        for (int i = 0; i < numBins; ++i)
+        //normalize the fft values and convert them to decibels a run at a time, non-finite bins end up at negativeInfinity
+        for (int startBin = 0; startBin < numBins; startBin += FFTEngine::binsPerRun)
         {
-            auto v = fftData[i];
-            //            fftData[i] /= (float) numBins;
-            if (!std::isinf(v) && !std::isnan(v))
-            {
-                v /= float(numBins);
-            }
-            else
-            {
-                v = 0.f;
-            }
-            fftData[i] = v;
+            const auto num = juce::jmin(FFTEngine::binsPerRun, numBins - startBin);
+            fftEngine->getMagnitudes(0, fftData.data() + startBin, startBin, num);
+            kernels.magnitudesToDecibels(fftData.data() + startBin, num, 1.f / float(numBins), negativeInfinity);
         }
 
-        //convert them to decibels
-        for (int i = 0; i < numBins; ++i)
+        fftDataFifo.commitWrite();
+    }
+
+    void changeOrder(FFTOrder newOrder, FFTBackend backend = getDefaultFFTBackend())
+    {
+        //when you change order, recreate the window, fftEngine, fifo, fftData
+        //also reset the fifoIndex
+        //things that need recreating should be created on the heap via std::make_unique<>
+
+        order = newOrder;
+        auto fftSize = getFFTSize();
+
+        fftEngine = createFFTEngine(backend, order);
+        windowTable.resize(fftSize);
+        juce::dsp::WindowingFunction<float>::fillWindowingTables(
+            windowTable.data(), (size_t)fftSize, juce::dsp::WindowingFunction<float>::blackmanHarris);
+
+        fftDataFifo.prepare((size_t)fftSize * 2);
+    }
+
+    //==============================================================================
+    int getFFTSize() const { return 1 << order; }
+    int getNumAvailableFFTDataBlocks() const { return fftDataFifo.getNumAvailableForReading(); }
+    //==============================================================================
+    //oldest frame of decibels, read in place then release it; nullptr when none is ready
+    const BlockType* acquireFFTData() { return fftDataFifo.acquireRead(); }
+    void releaseFFTData() { fftDataFifo.releaseRead(); }
+
+private:
+    FFTOrder order;
+    std::unique_ptr<FFTEngine> fftEngine;
+    std::vector<float> windowTable;
+    const DspKernels& kernels = getDspKernels();
+
+    Fifo<BlockType> fftDataFifo;
+};
+
+/*
+ Both channels through one FFTEngine transform, each engine does it its own
+ way (see JuceFFTEngine and BuiltInFFTEngine). The magnitudes are picked up
+ a run of bins at a time and normalised, averaged and converted to dB right
+ away, the frame is written once. With octave smoothing on, a channel's
+ magnitudes are smoothed as a whole first and the runs start from those.
+
+ Multi-resolution adds a second transform of the same size on the input
+ decimated by 4: decimation times finer bins for the low end, for two small
+ FFTs instead of one decimation times as large. The frame is then on the
+ fine grid, see stitchBands().
+
+ Zoom takes the complex baseband of a ZoomDownmixer instead, four channels
+ (re / im of channel 0, then of channel 1), through one complex FFT. Its
+ frame holds the middle half of that spectrum, N/2 bins around the centre
+ frequency, in the same layout as a full band frame.
+
+ Frame layout: decibels of channel 0 in [0, N/2), channel 1 in [N/2, N).
+ */
+template <typename BlockType>
+struct StereoFFTDataGenerator
+{
+    //multi-resolution: the low band is the same FFT size run on the input decimated by 'decimation'
+    static constexpr int decimation = 4;
+
+    /*
+     'lowBandData' is the decimated input, only in multi-resolution and
+     then required; its window spans decimation times as much audio.
+     In zoom 'audioData' is the downmixer's baseband window.
+     */
+    void produceFFTDataForRendering(const juce::AudioBuffer<float>& audioData, const float negativeInfinity,
+                                    const SpectrumAveraging& averaging = {},
+                                    const juce::AudioBuffer<float>* lowBandData = nullptr)
+    {
+        jassert((lowBandData != nullptr) == isMultiResolution());
+
+        auto* slot = fftDataFifo.acquireWrite();
+        if (slot == nullptr)
+            return;
+
+        if (averaging.mode != averagingMode)
+            resetAveraging(averaging.mode, negativeInfinity);
+
+        if (isZoom())
         {
-            fftData[i] = juce::Decibels::gainToDecibels(fftData[i], negativeInfinity);
+            transformZoom(audioData);
         }
+        else
+        {
+            const auto* channel0 = audioData.getReadPointer(0);
+            const auto* channel1 = audioData.getReadPointer(audioData.getNumChannels() > 1 ? 1 : 0);
+
+            fftEngine->transform(channel0, channel1, windowTable.data());
+        }
+
+        if (lowBandData != nullptr)
+            lowBandEngine->transform(lowBandData->getReadPointer(0),
+                                     lowBandData->getReadPointer(lowBandData->getNumChannels() > 1 ? 1 : 0),
+                                     windowTable.data());
+
+        auto& fftData = *slot;
+        const int numBins = getFrameSize() / 2;
+        //both transforms have the same size, so the same normalisation
+        const auto scale = 1.f / float(getFFTSize() / 2);
 
-        fftDataFifo.push(fftData);
+        auto weight = averaging.weight;
+        if (averagingMode == SpectrumAveraging::Infinite)
+            weight = 1.f / float(++numFramesAveraged);
+
+        //stitching, zoom and smoothing need the whole channel before any bin is final
+        const auto wholeChannel = mode != AnalyzerMode_FullBand || smoothing.isActive();
+
+        //the per-bin state is laid out like the frame
+        for (int channel = 0; channel < 2; ++channel)
+        {
+            auto* channelData = fftData.data() + channel * numBins;
+
+            if (isZoom())
+                getZoomMagnitudes(channel, channelData);
+            else if (isMultiResolution())
+                stitchBands(channel, channelData);
+            else if (wholeChannel)
+                fftEngine->getMagnitudes(channel, channelData, 0, numBins);
+
+            if (smoothing.isActive())
+                smoothing.process(channelData);
+
+            for (int startBin = 0; startBin < numBins; startBin += FFTEngine::binsPerRun)
+            {
+                const auto num = juce::jmin(FFTEngine::binsPerRun, numBins - startBin);
+                const auto offset = (size_t)(channel * numBins + startBin);
+                auto* data = fftData.data() + offset;
+                auto* state = averagingState.data() + offset;
+
+                if (!wholeChannel)
+                    fftEngine->getMagnitudes(channel, data, startBin, num);
+
+                switch (averagingMode)
+                {
+                    case SpectrumAveraging::Exponential:
+                    case SpectrumAveraging::Infinite:
+                        kernels.averagePowerToDecibels(data, state, num, scale, weight, negativeInfinity);
+                        break;
+                    case SpectrumAveraging::PeakHold:
+                        kernels.peakHoldToDecibels(data, state, num, scale, averaging.decayInDecibels, negativeInfinity);
+                        break;
+                    case SpectrumAveraging::Off:
+                    default:
+                        kernels.magnitudesToDecibels(data, num, scale, negativeInfinity);
+                        break;
+                }
+            }
+        }
+
+        fftDataFifo.commitWrite();
     }
 
-    void changeOrder(FFTOrder newOrder)
+    /*
+     Fractional-octave smoothing of the next frames, 0 = off; the band tables
+     are rebuilt only on a change. They assume bins from 0 Hz, so zoom frames
+     are left as they are.
+     */
+    void setSmoothing(int bandsPerOctave)
     {
-        //when you change order, recreate the window, forwardFFT, fifo, fftData
-        //also reset the fifoIndex
-        //things that need recreating should be created on the heap via std::make_unique<>
+        smoothingBandsPerOctave = bandsPerOctave;
+        smoothing.prepare(getFrameSize() / 2, isZoom() ? 0 : bandsPerOctave);
+    }
 
+    //forgets the running average / held peaks, e.g. to restart an infinite average
+    void resetAveraging(SpectrumAveraging::Mode mode, float negativeInfinity)
+    {
+        averagingMode = mode;
+        numFramesAveraged = 0;
+
+        //averages live in the power domain, held peaks in decibels
+        std::fill(averagingState.begin(), averagingState.end(),
+                  mode == SpectrumAveraging::PeakHold ? negativeInfinity : 0.f);
+    }
+
+    //the zoom FFT is complex, it always runs on juce::dsp::FFT whatever the backend
+    void changeOrder(FFTOrder newOrder, FFTBackend backend = getDefaultFFTBackend(),
+                     AnalyzerMode newMode = AnalyzerMode_FullBand)
+    {
         order = newOrder;
+        mode = newMode;
         auto fftSize = getFFTSize();
 
-        forwardFFT = std::make_unique<juce::dsp::FFT>(order);
-        window = std::make_unique<juce::dsp::WindowingFunction<float>>(
-            fftSize, juce::dsp::WindowingFunction<float>::blackmanHarris);
+        fftEngine = isZoom() ? nullptr : createFFTEngine(backend, order);
+        lowBandEngine = isMultiResolution() ? createFFTEngine(backend, order) : nullptr;
+        highBandMagnitudes.assign(isMultiResolution() ? (size_t)fftSize / 2 : 0, 0.f);
 
-        fftData.clear();
-        fftData.resize(fftSize * 2, 0);
+        zoomFFT = isZoom() ? std::make_unique<juce::dsp::FFT>(order) : nullptr;
+        for (auto& data : zoomData)
+        {
+            data.timeData.assign(isZoom() ? (size_t)fftSize : 0, {});
+            data.spectrum.assign(isZoom() ? (size_t)fftSize : 0, {});
+        }
 
-        fftDataFifo.prepare(fftData.size());
+        windowTable.resize((size_t)fftSize);
+        juce::dsp::WindowingFunction<float>::fillWindowingTables(
+            windowTable.data(), (size_t)fftSize, juce::dsp::WindowingFunction<float>::blackmanHarris);
+
+        const auto frameSize = getFrameSize();
+
+        averagingState.assign((size_t)frameSize, 0.f);
+        averagingMode = SpectrumAveraging::Off;
+        numFramesAveraged = 0;
+
+        smoothing.prepare(frameSize / 2, isZoom() ? 0 : smoothingBandsPerOctave);
+
+        fftDataFifo.prepare((size_t)frameSize);
     }
 
     //==============================================================================
     int getFFTSize() const { return 1 << order; }
+    bool isMultiResolution() const { return mode == AnalyzerMode_MultiResolution; }
+    bool isZoom() const { return mode == AnalyzerMode_Zoom; }
+    //the FFT size a frame's bins correspond to, decimation * getFFTSize() in multi-resolution
+    int getFrameSize() const { return getFFTSize() * (isMultiResolution() ? decimation : 1); }
     int getNumAvailableFFTDataBlocks() const { return fftDataFifo.getNumAvailableForReading(); }
     //==============================================================================
-    bool getFFTData(BlockType& fftData) { return fftDataFifo.pull(fftData); }
+    const BlockType* acquireFFTData() { return fftDataFifo.acquireRead(); }
+    void releaseFFTData() { fftDataFifo.releaseRead(); }
+
+    //bytes held by the buffers and the FFT engines
+    size_t getMemoryUsage() const
+    {
+        size_t zoomBytes = 0;
+        for (const auto& data : zoomData)
+            zoomBytes += (data.timeData.capacity() + data.spectrum.capacity()) * sizeof(juce::dsp::Complex<float>);
+
+        return (windowTable.capacity() + averagingState.capacity() + highBandMagnitudes.capacity()) * sizeof(float)
+               + zoomBytes + (fftEngine != nullptr ? fftEngine->getMemoryUsage() : 0)
+               + (lowBandEngine != nullptr ? lowBandEngine->getMemoryUsage() : 0) + smoothing.getMemoryUsage()
+               + (size_t)fftDataFifo.getCapacity() * (size_t)getFrameSize() * sizeof(float);
+    }
 
 private:
+    /*
+     One channel of a multi-resolution frame, on the fine grid of the low
+     band (sampleRate / getFrameSize() per bin). The low band is used up to a
+     quarter of the decimated band, where the decimation filter is still flat
+     and nothing has aliased into it; above that each fine bin repeats the
+     full rate bin it lies in.
+     */
+    void stitchBands(int channel, float* magnitudes)
+    {
+        const auto numBins = getFrameSize() / 2;
+        const auto crossoverBin = numBins / (2 * decimation);
+
+        lowBandEngine->getMagnitudes(channel, magnitudes, 0, crossoverBin);
+        fftEngine->getMagnitudes(channel, highBandMagnitudes.data(), 0, (int)highBandMagnitudes.size());
+
+        const auto lastHighBin = (int)highBandMagnitudes.size() - 1;
+        for (int bin = crossoverBin; bin < numBins; ++bin)
+            magnitudes[bin] = highBandMagnitudes[(size_t)juce::jmin(lastHighBin, (bin + decimation / 2) / decimation)];
+    }
+
+    //one complex FFT per channel of the baseband window
+    void transformZoom(const juce::AudioBuffer<float>& baseband)
+    {
+        jassert(baseband.getNumChannels() == 4 && baseband.getNumSamples() == getFFTSize());
+
+        for (int channel = 0; channel < 2; ++channel)
+        {
+            const auto* re = baseband.getReadPointer(2 * channel);
+            const auto* im = baseband.getReadPointer(2 * channel + 1);
+            auto& data = zoomData[channel];
+
+            for (size_t i = 0; i < data.timeData.size(); ++i)
+                data.timeData[i] = {re[i] * windowTable[i], im[i] * windowTable[i]};
+
+            zoomFFT->perform(data.timeData.data(), data.spectrum.data(), false);
+        }
+    }
+
+    //the bins from -N/4 to N/4 - 1 around the centre, the outer half is where the decimation filter rolls off
+    void getZoomMagnitudes(int channel, float* magnitudes) const
+    {
+        const auto& spectrum = zoomData[channel].spectrum;
+        const auto fftSize = getFFTSize();
+        const auto mask = fftSize - 1;
+
+        for (int bin = 0; bin < fftSize / 2; ++bin)
+            magnitudes[bin] = std::abs(spectrum[(size_t)((bin - fftSize / 4) & mask)]);
+    }
+
     FFTOrder order;
-    BlockType fftData;
-    std::unique_ptr<juce::dsp::FFT> forwardFFT;
-    std::unique_ptr<juce::dsp::WindowingFunction<float>> window;
+    AnalyzerMode mode = AnalyzerMode_FullBand;
+    std::unique_ptr<FFTEngine> fftEngine, lowBandEngine;
+    std::vector<float> windowTable, highBandMagnitudes;
 
-    Fifo<BlockType> fftDataFifo;
+    struct ZoomData
+    {
+        std::vector<juce::dsp::Complex<float>> timeData, spectrum;
+    };
+
+    std::unique_ptr<juce::dsp::FFT> zoomFFT;
+    ZoomData zoomData[2];
+    const DspKernels& kernels = getDspKernels();
+
+    std::vector<float> averagingState;
+    SpectrumAveraging::Mode averagingMode = SpectrumAveraging::Off;
+    int numFramesAveraged = 0;
+
+    FractionalOctaveSmoothing smoothing;
+    int smoothingBandsPerOctave = 0;
+
+    Fifo<BlockType> fftDataFifo{AnalyzerCapacity::fftFrames};
 };
 
 template <typename PathType>
@@ -254,14 +682,32 @@ struct AnalyzerPathGenerator
                       int fftSize,
                       float binWidth,
                       float negativeInfinity)
+    {
+        generatePath(renderData.data(), fftBounds, fftSize, binWidth, negativeInfinity);
+    }
+
+    /*
+     'renderData' holds fftSize / 2 bins, e.g. one channel of a stereo frame;
+     bin k is at startFrequency + k * binWidth, zoom frames don't start at 0 Hz
+     */
+    void generatePath(const float* renderData,
+                      juce::Rectangle<float> fftBounds,
+                      int fftSize,
+                      float binWidth,
+                      float negativeInfinity,
+                      float startFrequency = 0.f)
     {
         auto top = fftBounds.getY();
         auto bottom = fftBounds.getHeight();
         auto width = fftBounds.getWidth();
 
-        int numBins = (int)fftSize / 2;
+        //built in place in the ring, the display can't keep up anyway when it is full
+        auto* slot = pathFifo.acquireWrite();
+        if (slot == nullptr)
+            return;
 
-        PathType p;
+        auto& p = *slot;
+        p.clear();
         p.preallocateSpace(3 * (int)fftBounds.getWidth());
 
         auto map = [bottom, top, negativeInfinity](float v)
@@ -277,26 +723,25 @@ struct AnalyzerPathGenerator
         if (std::isnan(y) || std::isinf(y))
             y = bottom;
 
-        p.startNewSubPath(0, y);
+        updateBinMap(width, fftSize, binWidth, startFrequency);
 
-        const int pathResolution = 2; //you can draw line-to's every 'pathResolution' pixels.
+        //a zoom path starts where its region does
+        p.startNewSubPath(startFrequency != 0.f && !columns.empty() ? juce::jmax(0.f, columns.front().x) : 0.f, y);
 
-        for (int binNum = 1; binNum < numBins; binNum += pathResolution)
+        //one vertex per pixel column, the loudest bin of the column wins
+        for (const auto& column : columns)
         {
-            y = map(renderData[binNum]);
+            y = map(juce::FloatVectorOperations::findMaximum(renderData + column.firstBin, column.numBins));
 
             //            jassert( !std::isnan(y) && !std::isinf(y) );
 
             if (!std::isnan(y) && !std::isinf(y))
             {
-                auto binFreq = binNum * binWidth;
-                auto normalizedBinX = juce::mapFromLog10(binFreq, 20.f, 20000.f);
-                int binX = std::floor(normalizedBinX * width);
-                p.lineTo(binX, y);
+                p.lineTo(column.x, y);
             }
         }
 
-        pathFifo.push(p);
+        pathFifo.commitWrite();
     }
 
     int getNumPathsAvailable() const
@@ -304,14 +749,166 @@ struct AnalyzerPathGenerator
         return pathFifo.getNumAvailableForReading();
     }
 
+    //swaps the oldest path into 'path', no copy
     bool getPath(PathType& path)
     {
-        return pathFifo.pull(path);
+        if (auto* slot = pathFifo.acquireRead())
+        {
+            path.swapWithPath(*slot);
+            pathFifo.releaseRead();
+            return true;
+        }
+
+        return false;
     }
 
 private:
-    Fifo<PathType> pathFifo;
+    //consecutive bins that land in the same pixel column
+    struct ColumnRange
+    {
+        float x;
+        int firstBin, numBins;
+    };
+
+    std::vector<ColumnRange> columns;
+    float mappedWidth = 0.f, mappedBinWidth = 0.f, mappedStartFrequency = 0.f;
+    int mappedFFTSize = 0;
+
+    //log-frequency bin -> pixel map, only rebuilt when the width, FFT size, sample rate or zoom region change
+    void updateBinMap(float width, int fftSize, float binWidth, float startFrequency)
+    {
+        if (width == mappedWidth && fftSize == mappedFFTSize && binWidth == mappedBinWidth
+            && startFrequency == mappedStartFrequency)
+            return;
+
+        mappedWidth = width;
+        mappedFFTSize = fftSize;
+        mappedBinWidth = binWidth;
+        mappedStartFrequency = startFrequency;
+
+        columns.clear();
+
+        for (int binNum = 1; binNum < fftSize / 2; ++binNum)
+        {
+            auto binFreq = startFrequency + binNum * binWidth;
+
+            //a zoom region wider than its centre frequency reaches below 0 Hz
+            if (binFreq <= 0.f)
+                continue;
+
+            auto normalizedBinX = juce::mapFromLog10(binFreq, 20.f, 20000.f);
+            auto binX = std::floor(normalizedBinX * width);
+
+            if (!columns.empty() && columns.back().x == binX)
+                ++columns.back().numBins;
+            else
+                columns.push_back({binX, binNum, 1});
+        }
+    }
+
+    Fifo<PathType> pathFifo{AnalyzerCapacity::displayFrames};
+};
+
+//one spectrogram column, level in dB per pixel row, row 0 = 20 kHz
+struct SpectrogramColumn
+{
+    std::vector<float> levels;
+    int numRows = 0;
 };
 
+/*
+ Turns stereo FFT frames into spectrogram columns on the analyzer thread.
+ Each row takes the loudest bin of both channels in its log-frequency range,
+ the colouring is left to the display.
+ */
+struct SpectrogramColumnGenerator
+{
+    /*
+     'frame' is a StereoFFTDataGenerator frame: channel 0 in [0, N/2), channel 1 in [N/2, N),
+     bin k at startFrequency + k * binWidth. Rows outside a zoom frame get 'negativeInfinity'.
+     */
+    void generateColumn(const float* frame, int fftSize, float binWidth, int numRows,
+                        float startFrequency = 0.f, float negativeInfinity = -48.f)
+    {
+        //the slot belongs to this thread until it is committed, so it can be resized here
+        auto* slot = columnFifo.acquireWrite();
+        if (slot == nullptr)
+            return;
+
+        updateRowMap(numRows, fftSize, binWidth, startFrequency);
+
+        slot->levels.resize((size_t)numRows);
+        slot->numRows = numRows;
 
+        const auto numBins = fftSize / 2;
 
+        for (int row = 0; row < numRows; ++row)
+        {
+            const auto& range = rows[(size_t)row];
+            if (range.numBins == 0)
+            {
+                slot->levels[(size_t)row] = negativeInfinity;
+                continue;
+            }
+
+            slot->levels[(size_t)row] = juce::jmax(
+                juce::FloatVectorOperations::findMaximum(frame + range.firstBin, range.numBins),
+                juce::FloatVectorOperations::findMaximum(frame + numBins + range.firstBin, range.numBins));
+        }
+
+        columnFifo.commitWrite();
+    }
+
+    //oldest column, read in place then release it; nullptr when none is ready
+    const SpectrogramColumn* acquireColumn() { return columnFifo.acquireRead(); }
+    void releaseColumn() { columnFifo.releaseRead(); }
+
+private:
+    struct RowRange
+    {
+        int firstBin, numBins;
+    };
+
+    std::vector<RowRange> rows;
+    int mappedRows = 0, mappedFFTSize = 0;
+    float mappedBinWidth = 0.f, mappedStartFrequency = 0.f;
+
+    /*
+     pixel row -> bin range, at least one bin per row so the low end doesn't
+     leave gaps; no bins for the rows a zoom frame doesn't reach
+     */
+    void updateRowMap(int numRows, int fftSize, float binWidth, float startFrequency)
+    {
+        if (numRows == mappedRows && fftSize == mappedFFTSize && binWidth == mappedBinWidth
+            && startFrequency == mappedStartFrequency)
+            return;
+
+        mappedRows = numRows;
+        mappedFFTSize = fftSize;
+        mappedBinWidth = binWidth;
+        mappedStartFrequency = startFrequency;
+
+        rows.resize((size_t)numRows);
+        const auto lastBin = fftSize / 2 - 1;
+
+        for (int row = 0; row < numRows; ++row)
+        {
+            auto highFreq = juce::mapToLog10(1.f - float(row) / float(numRows), 20.f, 20000.f);
+            auto lowFreq = juce::mapToLog10(1.f - float(row + 1) / float(numRows), 20.f, 20000.f);
+
+            if (startFrequency != 0.f
+                && (highFreq < startFrequency || lowFreq > startFrequency + float(lastBin) * binWidth))
+            {
+                rows[(size_t)row] = {0, 0};
+                continue;
+            }
+
+            auto firstBin = juce::jlimit(1, lastBin, (int)std::floor((lowFreq - startFrequency) / binWidth));
+            auto endBin = juce::jlimit(firstBin + 1, lastBin + 1, (int)std::ceil((highFreq - startFrequency) / binWidth));
+
+            rows[(size_t)row] = {firstBin, endBin - firstBin};
+        }
+    }
+
+    Fifo<SpectrogramColumn> columnFifo{AnalyzerCapacity::displayFrames};
+};
@@ -0,0 +1,186 @@
+/*
+  ==============================================================================
+
+    SpectralEQ.cpp
+    Created: 19 Oct 2026 9:12:40am
+    Author:  tyzTang
+
+  ==============================================================================
+*/
+
+#include "SpectralEQ.h"
+
+void SpectralEQ::prepare(double newSampleRate, int numChannels)
+{
+    sampleRate = newSampleRate;
+
+    const auto maxSize = 1 << maxOrder;
+
+    for (int o = minOrder; o <= maxOrder; ++o)
+    {
+        auto index = o - minOrder;
+        auto size = 1 << o;
+
+        if (ffts[index] == nullptr)
+            ffts[index] = std::make_unique<juce::dsp::FFT>(o);
+
+        //periodic sqrt-Hann, used for both analysis and synthesis
+        auto& window = windows[index];
+        window.resize(size);
+        for (int i = 0; i < size; ++i)
+        {
+            auto hann = 0.5f - 0.5f * std::cos(juce::MathConstants<float>::twoPi * (float)i / (float)size);
+            window[i] = std::sqrt(hann);
+        }
+    }
+
+    channels.resize(numChannels);
+    for (auto& state : channels)
+    {
+        state.input.assign(maxSize, 0.f);
+        state.output.assign(maxSize, 0.f);
+    }
+
+    fftData.assign(maxSize * 2, 0.f);
+
+    juce::SpinLock::ScopedLockType lock(gainTableLock);
+    gainTable.resize(maxSize / 2 + 1);
+    pendingGainTable.resize(maxSize / 2 + 1);
+    rebuildGainTable(currentCurve, gainTable);
+    gainTableChanged = false;
+
+    reset();
+}
+
+void SpectralEQ::reset()
+{
+    for (auto& state : channels)
+    {
+        std::fill(state.input.begin(), state.input.end(), 0.f);
+        std::fill(state.output.begin(), state.output.end(), 0.f);
+        state.position = 0;
+    }
+    hopCounter = 0;
+}
+
+void SpectralEQ::setResolution(SpectralResolution resolution)
+{
+    auto newOrder = minOrder + (int)resolution;
+    if (newOrder == order)
+        return;
+
+    order = newOrder;
+    reset();
+}
+
+void SpectralEQ::setCurve(const SpectralCurve& curve)
+{
+    juce::SpinLock::ScopedLockType lock(gainTableLock);
+    currentCurve = curve;
+    rebuildGainTable(currentCurve, pendingGainTable);
+    gainTableChanged = true;
+}
+
+void SpectralEQ::process(juce::dsp::AudioBlock<float>& block)
+{
+    //pick up the latest drawn curve without ever waiting on the message thread
+    if (gainTableChanged.load())
+    {
+        juce::SpinLock::ScopedTryLockType lock(gainTableLock);
+        if (lock.isLocked())
+        {
+            std::swap(gainTable, pendingGainTable);
+            gainTableChanged = false;
+        }
+    }
+
+    const auto fftSize = 1 << order;
+    const auto hopSize = fftSize / overlap;
+    const auto numChannels = juce::jmin((int)block.getNumChannels(), (int)channels.size());
+    const auto numSamples = (int)block.getNumSamples();
+
+    int startHop = hopCounter;
+    for (int ch = 0; ch < numChannels; ++ch)
+    {
+        auto& state = channels[ch];
+        auto* data = block.getChannelPointer(ch);
+        hopCounter = startHop;
+
+        for (int i = 0; i < numSamples; ++i)
+        {
+            state.input[state.position] = data[i];
+            data[i] = state.output[state.position];
+            state.output[state.position] = 0.f;
+
+            state.position = (state.position + 1) & (fftSize - 1);
+
+            if (++hopCounter == hopSize)
+            {
+                hopCounter = 0;
+                processFrame(state);
+            }
+        }
+    }
+}
+
+void SpectralEQ::processFrame(ChannelState& state)
+{
+    const auto fftSize = 1 << order;
+    const auto& window = windows[order - minOrder];
+    const auto numBins = fftSize / 2;
+    const auto stride = 1 << (maxOrder - order);
+
+    //oldest sample sits at the write position
+    for (int i = 0; i < fftSize; ++i)
+        fftData[i] = state.input[(state.position + i) & (fftSize - 1)] * window[i];
+
+    std::fill(fftData.begin() + fftSize, fftData.begin() + fftSize * 2, 0.f);
+
+    auto& fft = *ffts[order - minOrder];
+    fft.performRealOnlyForwardTransform(fftData.data(), true);
+
+    for (int bin = 0; bin <= numBins; ++bin)
+    {
+        auto gain = gainTable[bin * stride];
+        fftData[bin * 2] *= gain;
+        fftData[bin * 2 + 1] *= gain;
+    }
+
+    fft.performRealOnlyInverseTransform(fftData.data());
+
+    //Hann summed at an overlap of N adds up to N / 2
+    const auto normalisation = 2.f / (float)overlap;
+    for (int i = 0; i < fftSize; ++i)
+        state.output[(state.position + i) & (fftSize - 1)] += fftData[i] * window[i] * normalisation;
+}
+
+void SpectralEQ::rebuildGainTable(const SpectralCurve& curve, std::vector<float>& table) const
+{
+    const auto maxSize = 1 << maxOrder;
+    const auto binWidth = (float)(sampleRate / (double)maxSize);
+
+    for (size_t bin = 0; bin < table.size(); ++bin)
+    {
+        auto freq = juce::jmax(1.f, (float)bin * binWidth);
+        table[bin] = juce::Decibels::decibelsToGain(getGainForFrequency(curve, freq));
+    }
+}
+
+float SpectralEQ::getGainForFrequency(const SpectralCurve& curve, float frequency)
+{
+    if (curve.empty())
+        return 0.f;
+
+    if (frequency <= curve.front().frequency)
+        return curve.front().gainInDecibels;
+
+    if (frequency >= curve.back().frequency)
+        return curve.back().gainInDecibels;
+
+    auto upper = std::lower_bound(curve.begin(), curve.end(), frequency,
+                                  [](const SpectralCurvePoint& p, float f) { return p.frequency < f; });
+    auto lower = upper - 1;
+
+    auto proportion = std::log(frequency / lower->frequency) / std::log(upper->frequency / lower->frequency);
+    return juce::jmap(proportion, lower->gainInDecibels, upper->gainInDecibels);
+}
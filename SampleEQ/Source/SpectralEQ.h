@@ -0,0 +1,85 @@
+/*
+  ==============================================================================
+
+    SpectralEQ.h
+    Created: 19 Oct 2026 9:12:40am
+    Author:  tyzTang
+
+  ==============================================================================
+*/
+
+#pragma once
+#include <JuceHeader.h>
+
+struct SpectralCurvePoint
+{
+    float frequency{1000.f}, gainInDecibels{0.f};
+};
+
+using SpectralCurve = std::vector<SpectralCurvePoint>;
+
+enum SpectralResolution
+{
+    Spectral_1024,
+    Spectral_2048,
+    Spectral_4096,
+    Spectral_8192,
+};
+
+/*
+ Overlap-add STFT equaliser.
+ Every bin is scaled by a gain interpolated from a drawn curve, so the cost
+ only depends on the FFT size and never on the number of breakpoints.
+
+ sqrt-Hann analysis and synthesis windows at 75% overlap.
+ Latency is exactly one FFT frame.
+ */
+class SpectralEQ
+{
+public:
+    static constexpr int minOrder = 10;
+    static constexpr int maxOrder = 13;
+    static constexpr int overlap = 4;
+
+    //allocates everything for maxOrder, so switching resolution never allocates
+    void prepare(double sampleRate, int numChannels);
+    void reset();
+
+    //audio thread
+    void setResolution(SpectralResolution resolution);
+    void process(juce::dsp::AudioBlock<float>& block);
+
+    //message thread
+    void setCurve(const SpectralCurve& curve);
+
+    int getLatencyInSamples() const { return 1 << order; }
+    static int getLatencyInSamples(SpectralResolution resolution) { return 1 << (minOrder + resolution); }
+
+    //log-frequency / linear-dB interpolation of the drawn curve, flat outside the end points
+    static float getGainForFrequency(const SpectralCurve& curve, float frequency);
+
+private:
+    struct ChannelState
+    {
+        std::vector<float> input, output;
+        int position = 0;
+    };
+
+    void processFrame(ChannelState& state);
+    void rebuildGainTable(const SpectralCurve& curve, std::vector<float>& table) const;
+
+    int order = minOrder + Spectral_2048;
+    int hopCounter = 0;
+    double sampleRate = 44100.0;
+
+    std::array<std::unique_ptr<juce::dsp::FFT>, maxOrder - minOrder + 1> ffts;
+    std::array<std::vector<float>, maxOrder - minOrder + 1> windows;
+    std::vector<ChannelState> channels;
+    std::vector<float> fftData;
+
+    //bin gains at maxOrder resolution, smaller orders read them with a stride
+    std::vector<float> gainTable, pendingGainTable;
+    SpectralCurve currentCurve;
+    juce::SpinLock gainTableLock;
+    std::atomic<bool> gainTableChanged{false};
+};
@@ -0,0 +1,97 @@
+/*
+  ==============================================================================
+
+    SpectrogramComponent.cpp
+    Created: 19 Oct 2026 8:14:52pm
+    Author:  tyzTang
+
+  ==============================================================================
+*/
+
+#include "SpectrogramComponent.h"
+
+SpectrogramComponent::SpectrogramComponent(PathProducer& producer) : pathProducer(producer)
+{
+    using namespace juce;
+
+    ColourGradient gradient(Colours::black, 0.f, 0.f, Colours::white, 1.f, 0.f, false);
+    gradient.addColour(0.25, Colours::darkblue);
+    gradient.addColour(0.5, Colours::purple);
+    gradient.addColour(0.75, Colours::orange);
+    gradient.addColour(0.9, Colours::yellow);
+
+    for (int i = 0; i < colourTableSize; ++i)
+        colourTable[(size_t)i] = gradient.getColourAtPosition(double(i) / double(colourTableSize - 1)).getPixelARGB();
+
+    setOpaque(true);
+}
+
+SpectrogramComponent::~SpectrogramComponent()
+{
+    pathProducer.setSpectrogramRows(0);
+}
+
+void SpectrogramComponent::onVBlank()
+{
+    bool gotNewColumn = false;
+
+    while (auto* column = pathProducer.acquireSpectrogramColumn())
+    {
+        writeColumn(*column);
+        pathProducer.releaseSpectrogramColumn();
+        gotNewColumn = true;
+    }
+
+    if (gotNewColumn)
+        repaint();
+}
+
+void SpectrogramComponent::writeColumn(const SpectrogramColumn& column)
+{
+    //columns made for the previous height are dropped
+    if (!image.isValid() || column.numRows != image.getHeight())
+        return;
+
+    juce::Image::BitmapData pixels(image, writePosition, 0, 1, image.getHeight(), juce::Image::BitmapData::writeOnly);
+
+    for (int row = 0; row < column.numRows; ++row)
+    {
+        auto index = juce::jlimit(0, colourTableSize - 1,
+                                  (int)juce::jmap(column.levels[(size_t)row], -48.f, 0.f, 0.f, float(colourTableSize - 1)));
+        reinterpret_cast<juce::PixelARGB*>(pixels.getPixelPointer(0, row))->set(colourTable[(size_t)index]);
+    }
+
+    writePosition = (writePosition + 1) % image.getWidth();
+}
+
+void SpectrogramComponent::paint(juce::Graphics& g)
+{
+    if (!image.isValid())
+        return;
+
+    //oldest column sits at the write position
+    const auto width = image.getWidth();
+    const auto height = image.getHeight();
+    const auto olderWidth = width - writePosition;
+
+    g.drawImage(image, 0, 0, olderWidth, height, writePosition, 0, olderWidth, height);
+
+    if (writePosition > 0)
+        g.drawImage(image, olderWidth, 0, writePosition, height, 0, 0, writePosition, height);
+}
+
+void SpectrogramComponent::resized()
+{
+    if (getWidth() <= 0 || getHeight() <= 0)
+    {
+        image = {};
+        pathProducer.setSpectrogramRows(0);
+        return;
+    }
+
+    image = juce::Image(juce::Image::ARGB, getWidth(), getHeight(), true);
+    image.clear(image.getBounds(), juce::Colours::black);
+    writePosition = 0;
+
+    pathProducer.setSpectrogramRows(getHeight());
+}
@@ -0,0 +1,58 @@
+/*
+  ==============================================================================
+
+    SpectrogramComponent.h
+    Created: 19 Oct 2026 8:14:52pm
+    Author:  tyzTang
+
+  ==============================================================================
+*/
+
+#pragma once
+#include <JuceHeader.h>
+
+#include "PathProducer.h"
+
+/*
+ Scrolling spectrogram under the line analyzer, time runs left to right.
+
+ The image is a ring: every analyzer frame overwrites one pixel column at the
+ write position through a colour lookup table, so a frame costs O(height).
+ paint() draws it as two blits split at the write position, the image is
+ never re-rendered as a whole.
+ */
+struct SpectrogramComponent : juce::Component,
+                              juce::TooltipClient
+{
+    SpectrogramComponent(PathProducer& producer);
+    ~SpectrogramComponent() override;
+
+    void paint(juce::Graphics& g) override;
+    void resized() override;
+
+    //bytes held by the ring image
+    size_t getMemoryUsage() const
+    {
+        return image.isValid() ? (size_t)image.getWidth() * (size_t)image.getHeight() * sizeof(juce::PixelARGB) : 0;
+    }
+
+    juce::String getTooltip() override
+    {
+        return "Spectrogram memory: " + juce::File::descriptionOfSizeInBytes((juce::int64)getMemoryUsage());
+    }
+
+private:
+    void onVBlank();
+    void writeColumn(const SpectrogramColumn& column);
+
+    PathProducer& pathProducer;
+
+    juce::Image image;
+    int writePosition = 0;
+
+    //-48 dB .. 0 dB
+    static constexpr int colourTableSize = 256;
+    std::array<juce::PixelARGB, colourTableSize> colourTable;
+
+    juce::VBlankAttachment vBlankAttachment{this, [this] { onVBlank(); }};
+};
@@ -0,0 +1,136 @@
+/*
+  ==============================================================================
+
+    SpectrumRecorder.cpp
+    Created: 19 Oct 2026 9:37:05pm
+    Author:  tyzTang
+
+  ==============================================================================
+*/
+
+#include "SpectrumRecorder.h"
+
+#if !JUCE_LITTLE_ENDIAN
+ #error "spectrum recordings are written in host order, which is assumed to be little endian"
+#endif
+
+SpectrumRecorder::SpectrumRecorder() : juce::Thread("SampleEQ Spectrum Recorder")
+{
+}
+
+SpectrumRecorder::~SpectrumRecorder()
+{
+    stop();
+}
+
+bool SpectrumRecorder::start(const juce::File& file)
+{
+    stop();
+
+    file.deleteFile();
+    auto newStream = std::make_unique<juce::FileOutputStream>(file);
+    if (!newStream->openedOk())
+        return false;
+
+    //anything a previous recording left in the ring
+    while (frames.acquireRead() != nullptr)
+        frames.releaseRead();
+
+    stream = std::move(newStream);
+    headerWritten = false;
+    framesWritten = 0;
+    framesDropped = 0;
+
+    recording = true;
+    startThread(juce::Thread::Priority::background);
+    return true;
+}
+
+void SpectrumRecorder::stop()
+{
+    recording = false;
+    stopThread(2000);
+
+    //the writer thread has stopped, whatever is still queued goes out here
+    writePendingFrames();
+
+    //already gone if a format change ended the file
+    if (stream != nullptr)
+    {
+        stream->flush();
+        stream.reset();
+    }
+}
+
+void SpectrumRecorder::pushFrame(const float* decibels, int fftSize, double sampleRate, double timestamp)
+{
+    if (!recording.load())
+        return;
+
+    auto* slot = frames.acquireWrite();
+    if (slot == nullptr)
+    {
+        ++framesDropped;
+        return;
+    }
+
+    //the slot is ours until it is committed, it only grows with the FFT size
+    slot->decibels.assign(decibels, decibels + fftSize);
+    slot->fftSize = fftSize;
+    slot->sampleRate = sampleRate;
+    slot->timestamp = timestamp;
+
+    frames.commitWrite();
+}
+
+void SpectrumRecorder::run()
+{
+    while (!threadShouldExit())
+    {
+        writePendingFrames();
+        wait(writeIntervalMilliseconds);
+    }
+}
+
+void SpectrumRecorder::writePendingFrames()
+{
+    while (auto* frame = frames.acquireRead())
+    {
+        if (stream != nullptr && !headerWritten)
+        {
+            header = {};
+            std::memcpy(header.magic, "SEQS", 4);
+            header.version = fileVersion;
+            header.fftSize = (juce::uint32)frame->fftSize;
+            header.valuesPerFrame = (juce::uint32)frame->fftSize;
+            header.sampleRate = frame->sampleRate;
+            header.numChannels = 2;
+
+            stream->write(&header, sizeof(header));
+            headerWritten = true;
+            startTimestamp = frame->timestamp;
+        }
+
+        if (stream != nullptr
+            && ((juce::uint32)frame->fftSize != header.fftSize || frame->sampleRate != header.sampleRate))
+        {
+            recording = false;
+            stream->flush();
+            stream.reset();
+            signalThreadShouldExit();
+
+            if (onEndedEarly != nullptr)
+                onEndedEarly();
+        }
+
+        if (stream != nullptr)
+        {
+            const double timestamp = frame->timestamp - startTimestamp;
+            stream->write(&timestamp, sizeof(double));
+            stream->write(frame->decibels.data(), frame->decibels.size() * sizeof(float));
+            ++framesWritten;
+        }
+
+        frames.releaseRead();
+    }
+}
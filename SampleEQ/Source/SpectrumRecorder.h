@@ -0,0 +1,98 @@
+/*
+  ==============================================================================
+
+    SpectrumRecorder.h
+    Created: 19 Oct 2026 9:37:05pm
+    Author:  tyzTang
+
+  ==============================================================================
+*/
+
+#pragma once
+#include <JuceHeader.h>
+
+#include "SingleChannelSampleFifo.h"
+
+/*
+ Spectrum recording file, append-only, little endian:
+
+     header  "SEQS", uint32 version, uint32 fftSize, uint32 valuesPerFrame,
+             float64 sampleRate, uint32 numChannels, uint32 reserved    (32 bytes)
+     frame   float64 seconds of audio since the first frame of the recording,
+             float32 dB[valuesPerFrame] laid out like a StereoFFTDataGenerator frame
+
+ Every frame has the same size, so a file can be read in place through a memory map.
+ */
+struct SpectrumFileHeader
+{
+    char magic[4];
+    juce::uint32 version;
+    juce::uint32 fftSize;
+    juce::uint32 valuesPerFrame;
+    double sampleRate;
+    juce::uint32 numChannels;
+    juce::uint32 reserved;
+};
+
+static_assert(sizeof(SpectrumFileHeader) == 32, "the header is written as is and read in place");
+
+/*
+ Streams the analyzer frames of one editor to disk.
+
+ pushFrame() is called on the analyzer thread and only copies the frame into
+ a lock-free ring; a writer thread of its own appends them to the file, so
+ neither the audio thread nor the analysis ever waits for the disk. Frames
+ that don't fit in the ring are dropped and counted.
+
+ The header is taken from the first frame. A frame with another FFT size or
+ sample rate ends the recording, the file keeps one format throughout, and
+ onEndedEarly tells the owner.
+ */
+class SpectrumRecorder : private juce::Thread
+{
+public:
+    SpectrumRecorder();
+    ~SpectrumRecorder() override;
+
+    //message thread
+    bool start(const juce::File& file);
+    void stop();
+    //false once stop() or a format change ended the file, the writer thread exits with it
+    bool isRecording() const { return recording.load(); }
+
+    //writer thread, after a format change ended the file; stop() is still up to the owner
+    std::function<void()> onEndedEarly;
+
+    juce::uint64 getNumFramesWritten() const { return framesWritten.load(); }
+    juce::uint64 getNumFramesDropped() const { return framesDropped.load(); }
+
+    //analyzer thread
+    void pushFrame(const float* decibels, int fftSize, double sampleRate, double timestamp);
+
+    static constexpr juce::uint32 fileVersion = 1;
+    static constexpr int writeIntervalMilliseconds = 50;
+
+private:
+    struct Frame
+    {
+        std::vector<float> decibels;
+        int fftSize = 0;
+        double sampleRate = 0.0;
+        double timestamp = 0.0;
+    };
+
+    void run() override;
+    void writePendingFrames();
+
+    //two write intervals of analyzer frames
+    Fifo<Frame> frames{2 * writeIntervalMilliseconds / AnalyzerWorker::intervalMilliseconds + 2};
+    std::unique_ptr<juce::FileOutputStream> stream;
+    SpectrumFileHeader header{};
+    bool headerWritten = false;
+    double startTimestamp = 0.0;
+
+    std::atomic<bool> recording{false};
+    std::atomic<juce::uint64> framesWritten{0}, framesDropped{0};
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(SpectrumRecorder)
+};
@@ -0,0 +1,54 @@
+/*
+  ==============================================================================
+
+    TripleBuffer.h
+    Created: 19 Oct 2026 3:05:44pm
+    Author:  tyzTang
+
+  ==============================================================================
+*/
+
+#pragma once
+#include <JuceHeader.h>
+
+/*
+ Single producer / single consumer hand-off of the latest complete value.
+
+ The producer fills getWriteBuffer() and publishes it, the consumer calls
+ update() and then reads getReadBuffer(). Neither side ever waits or
+ allocates, intermediate values the consumer didn't pick up are dropped.
+ */
+template <typename T>
+class TripleBuffer
+{
+public:
+    //producer
+    T& getWriteBuffer() noexcept { return buffers[writeIndex]; }
+
+    void publish() noexcept
+    {
+        auto previous = middle.exchange(writeIndex | newDataBit, std::memory_order_acq_rel);
+        writeIndex = previous & indexMask;
+    }
+
+    //consumer, returns true if a newer value was picked up
+    bool update() noexcept
+    {
+        if ((middle.load(std::memory_order_relaxed) & newDataBit) == 0)
+            return false;
+
+        auto previous = middle.exchange(readIndex, std::memory_order_acq_rel);
+        readIndex = previous & indexMask;
+        return true;
+    }
+
+    const T& getReadBuffer() const noexcept { return buffers[readIndex]; }
+
+private:
+    static constexpr int indexMask = 3;
+    static constexpr int newDataBit = 4;
+
+    std::array<T, 3> buffers;
+    int writeIndex = 0, readIndex = 1;
+    std::atomic<int> middle{2};
+};
@@ -0,0 +1,100 @@
+/*
+  ==============================================================================
+
+    ZoomDownmixer.cpp
+    Created: 19 Oct 2026 11:26:41pm
+    Author:  tyzTang
+
+  ==============================================================================
+*/
+
+#include "ZoomDownmixer.h"
+
+void ZoomDownmixer::prepare(double newSampleRate, float newLowFrequency, float newHighFrequency, int fftSize)
+{
+    sampleRate = newSampleRate;
+    lowFrequency = newLowFrequency;
+    highFrequency = newHighFrequency;
+    centreFrequency = 0.5f * (lowFrequency + highFrequency);
+
+    //the middle half of the decimated band, sampleRate / (2 * factor), has to hold the region
+    const auto span = juce::jmax(1.0, (double)std::abs(highFrequency - lowFrequency));
+    int factor = 1;
+    while (factor < maxFactor && sampleRate / (2 * factor) >= 2.0 * span)
+        factor *= 2;
+
+    decimator.prepare(4, factor, tapsPerPhase, 0.5 / factor);
+
+    const auto phasePerSample = -juce::MathConstants<double>::twoPi * centreFrequency / sampleRate;
+    rotation = std::polar(1.0, phasePerSample);
+
+    mixed.setSize(4, chunkSize);
+    decimated.setSize(4, chunkSize / factor + 1);
+    baseband.setSize(4, fftSize);
+
+    reset();
+}
+
+void ZoomDownmixer::reset()
+{
+    decimator.reset();
+    baseband.clear();
+    oscillator = {1.0, 0.0};
+}
+
+bool ZoomDownmixer::isPreparedFor(double newSampleRate, float newLowFrequency, float newHighFrequency, int fftSize) const
+{
+    return newSampleRate == sampleRate && newLowFrequency == lowFrequency && newHighFrequency == highFrequency
+           && fftSize == baseband.getNumSamples();
+}
+
+void ZoomDownmixer::process(const juce::AudioBuffer<float>& input, int numSamples)
+{
+    const auto windowSize = baseband.getNumSamples();
+
+    for (int start = 0; start < numSamples; start += chunkSize)
+    {
+        const auto size = juce::jmin(chunkSize, numSamples - start);
+
+        //x * e^(-j w n), both channels share the oscillator
+        const auto* left = input.getReadPointer(0, start);
+        const auto* right = input.getReadPointer(input.getNumChannels() > 1 ? 1 : 0, start);
+        auto* const* out = mixed.getArrayOfWritePointers();
+
+        for (int i = 0; i < size; ++i)
+        {
+            const auto re = (float)oscillator.real(), im = (float)oscillator.imag();
+            out[0][i] = left[i] * re;
+            out[1][i] = left[i] * im;
+            out[2][i] = right[i] * re;
+            out[3][i] = right[i] * im;
+
+            oscillator *= rotation;
+        }
+
+        //keeps the rounding errors of the recursion from growing
+        oscillator /= std::abs(oscillator);
+
+        const auto numDecimated = decimator.process(mixed.getArrayOfReadPointers(), size,
+                                                    decimated.getArrayOfWritePointers());
+
+        //slide the new baseband samples in at the end of the window
+        const auto numNew = juce::jmin(numDecimated, windowSize);
+        for (int channel = 0; channel < 4; ++channel)
+        {
+            auto* data = baseband.getWritePointer(channel);
+            std::memmove(data, data + numNew, (size_t)(windowSize - numNew) * sizeof(float));
+            std::memcpy(data + windowSize - numNew, decimated.getReadPointer(channel, numDecimated - numNew),
+                        (size_t)numNew * sizeof(float));
+        }
+    }
+}
+
+size_t ZoomDownmixer::getMemoryUsage() const
+{
+    size_t samples = 0;
+    for (const auto* buffer : {&mixed, &decimated, &baseband})
+        samples += (size_t)buffer->getNumChannels() * (size_t)buffer->getNumSamples();
+
+    return samples * sizeof(float) + decimator.getMemoryUsage();
+}
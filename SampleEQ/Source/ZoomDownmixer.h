@@ -0,0 +1,63 @@
+/*
+  ==============================================================================
+
+    ZoomDownmixer.h
+    Created: 19 Oct 2026 11:26:41pm
+    Author:  tyzTang
+
+  ==============================================================================
+*/
+
+#pragma once
+#include <JuceHeader.h>
+
+#include "Decimator.h"
+
+/*
+ The front end of the zoom analyzer: shifts one frequency region of a stereo
+ signal down to 0 Hz, then decimates it with the polyphase Decimator so that
+ a small complex FFT covers only that region.
+
+ The factor is the largest power of two that leaves the middle half of the
+ decimated band at least as wide as the region. That half is what gets
+ displayed, the filter is flat there and nothing aliases into it; so the
+ region shown can be up to twice as wide as the one asked for.
+ */
+class ZoomDownmixer
+{
+public:
+    //'fftSize' samples of baseband are kept, the newest last
+    void prepare(double sampleRate, float lowFrequency, float highFrequency, int fftSize);
+    void reset();
+
+    //two channels of input, any number of samples
+    void process(const juce::AudioBuffer<float>& input, int numSamples);
+
+    //re / im of channel 0, then re / im of channel 1
+    const juce::AudioBuffer<float>& getBaseband() const { return baseband; }
+
+    int getFactor() const { return decimator.getFactor(); }
+    float getCentreFrequency() const { return centreFrequency; }
+    double getBasebandSampleRate() const { return sampleRate / getFactor(); }
+
+    //true when prepare() would come up with the same region
+    bool isPreparedFor(double newSampleRate, float lowFrequency, float highFrequency, int fftSize) const;
+
+    size_t getMemoryUsage() const;
+
+    //regions narrower than sampleRate / (2 * maxFactor) are shown that wide
+    static constexpr int maxFactor = 1024;
+
+private:
+    static constexpr int tapsPerPhase = 16;
+    static constexpr int chunkSize = 1024;
+
+    double sampleRate = 0.0;
+    float lowFrequency = 0.f, highFrequency = 0.f, centreFrequency = 0.f;
+
+    //e^(-j 2 pi centre / sampleRate), renormalised after every chunk
+    std::complex<double> oscillator{1.0, 0.0}, rotation{1.0, 0.0};
+
+    Decimator decimator;
+    juce::AudioBuffer<float> mixed, decimated, baseband;
+};